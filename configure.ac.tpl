@@ -55,6 +55,12 @@ dnl        [AC_MSG_ERROR([no C++11 standard supported. On MacOSX try to use CC=c
 
 AM_CONDITIONAL( [ISGCC], [test x${GCC} = xyes] )
 
+# OpenMP for parallel contacts detection (--disable-openmp to turn off)
+AC_LANG_PUSH([C++])
+AC_OPENMP
+AC_LANG_POP([C++])
+AC_SUBST(OPENMP_CXXFLAGS)
+
 # ====================================================================
 #                  *********  MAKEFILES *********
 # ====================================================================
@@ -105,6 +111,62 @@ AC_ARG_ENABLE( [fp-check],
 
 AM_CONDITIONAL( [FPCHECK], [test x$fpcheck = xtrue] )
 
+# --------------------------------------------------------------------
+# Mixed precision: narrow phase geometry kernels in float, positions and
+# quaternions in double
+# --------------------------------------------------------------------
+
+AC_ARG_ENABLE( [mixed-precision],
+   [AS_HELP_STRING( [--enable-mixed-precision],
+                    [run polygons clipping in float precision] )],
+   [case "${enableval}" in
+    yes) mixedprec=true  ;;
+     no) mixedprec=false ;;
+      *) AC_MSG_ERROR( [bad value ${enableval}
+                        for --enable-mixed-precision]) ;;
+    esac],
+   [mixedprec=false] )
+
+AM_CONDITIONAL( [MIXEDPREC], [test x$mixedprec = xtrue] )
+
+# --------------------------------------------------------------------
+# Validation of narrow phase precision: each clipping is repeated in
+# double and compared (for developers, slow)
+# --------------------------------------------------------------------
+
+AC_ARG_ENABLE( [precision-check],
+   [AS_HELP_STRING( [--enable-precision-check],
+                    [compare narrow phase results with double precision
+                     ones and print the differences statistics] )],
+   [case "${enableval}" in
+    yes) preccheck=true  ;;
+     no) preccheck=false ;;
+      *) AC_MSG_ERROR( [bad value ${enableval}
+                        for --enable-precision-check]) ;;
+    esac],
+   [preccheck=false] )
+
+AM_CONDITIONAL( [PRECCHECK], [test x$preccheck = xtrue] )
+
+# --------------------------------------------------------------------
+# Separating axis test statistics of contact forces (shared counters
+# updated by every contact, for developers)
+# --------------------------------------------------------------------
+
+AC_ARG_ENABLE( [contact-stats],
+   [AS_HELP_STRING( [--enable-contact-stats],
+                    [count separating axis test outcomes and print them
+                     at the end of run] )],
+   [case "${enableval}" in
+    yes) contstats=true  ;;
+     no) contstats=false ;;
+      *) AC_MSG_ERROR( [bad value ${enableval}
+                        for --enable-contact-stats]) ;;
+    esac],
+   [contstats=false] )
+
+AM_CONDITIONAL( [CONTSTATS], [test x$contstats = xtrue] )
+
 # --------------------------------------------------------------------
 # Enabling output additional configuration info after configure
 # --------------------------------------------------------------------
@@ -215,6 +277,9 @@ AC_MSG_NOTICE( [----------------------------------------------------- ] )
 AC_MSG_NOTICE( [System:                              ${target_os_base}] )
 AC_MSG_NOTICE( [Output gmon.out for profiling:       ${profile}  ] )
 AC_MSG_NOTICE( [Float point correctness check:       ${fpcheck}  ] )
+AC_MSG_NOTICE( [Mixed precision (float geometry):    ${mixedprec}  ] )
+AC_MSG_NOTICE( [Narrow phase precision check:        ${preccheck}  ] )
+AC_MSG_NOTICE( [OpenMP flags:                        ${OPENMP_CXXFLAGS}] )
 AC_MSG_NOTICE( [Python version:                      ${PYTHON_VERSION}] )
 AC_MSG_NOTICE( [----------------------------------------------------- ] )
 AC_MSG_NOTICE( [ ] )
@@ -25,6 +25,8 @@ MASK = {
     'SAVE' : 1,
     'WINDS' : 2,
     'CURRENTS' : 4,
+    'PHYS_CONSTS' : 8,
+    'MATERIALS' : 16,
 
     'EXIT' : 128
     }
@@ -35,14 +37,23 @@ MASK = {
 
 CONTACT_METHODS = {
     'n2' : 0,
-    'sweep' : 1
+    'sweep' : 1,
+    'cells' : 2,
+    'tree' : 3
     }
 
 CONTACT_DET_FREQ_MET = {
     'always' : 0,
     'ticks' : 1, 'tick' : 1,
     'sec' : 2, 'seconds' : 2,
-    'speed' : 3, 'auto' : 3
+    'speed' : 3, 'auto' : 3,
+    'skin' : 4, 'verlet' : 4
+    }
+
+CONTACT_CASCADE = {
+    'cap' : 0,
+    'box' : 1, 'obb' : 1,
+    'polygon' : 2, 'poly' : 2
     }
 
 CONTACT_FORCE_MODEL = {
@@ -92,9 +103,40 @@ settings = Settings()
 settings.contact_method = CONTACT_METHODS['sweep']
 settings.contact_freq_met = CONTACT_DET_FREQ_MET['always']
 settings.contact_value = 1
+# mid phase tests applied after broad phase: bounding caps only, + oriented
+# bounding boxes, + exact polygons test
+settings.contact_cascade = CONTACT_CASCADE['cap']
 
 settings.force_model = CONTACT_FORCE_MODEL['default']
 
+# contact forces are summed in contacts` order: results do not depend on the
+# amount of threads (1) or in threads` order - faster (0)
+settings.deterministic_sum = 0
+
+# dynamics, position and properties update in one fused multithreaded pass
+# over elements (1) or in separate passes - reference path (0)
+settings.fused_integration = 1
+
+# period (in steps) of elements reordering along space filling curve for
+# memory locality. 0 - never
+settings.reorder_period = 0
+
+# simplified convex collision polygons for elements with many vertices (used
+# for collisions and fastening): maximal amount of vertices (0 - exact
+# polygons are used) and maximal error relative to element size
+settings.proxy_vertices = 0
+settings.proxy_error = 0.05
+
+# sleeping of calm islands (elements connected by contacts): amount of steps
+# all elements of island must stay below thresholds to fall asleep (0 - off)
+# and thresholds of speed (m/s), spin (1/s) and acceleration (m/s^2). Islands
+# wake up on contacts with moving elements or on mass forces change above
+# the acceleration threshold
+settings.sleep_steps = 0
+settings.sleep_velocity = 1e-3
+settings.sleep_spin = 1e-5
+settings.sleep_acceleration = 1e-5
+
 settings.wind_source_type = WIND_SOURCES['TEST']
 settings.wind_source_names = []
 
@@ -10,12 +10,51 @@
 #define AUXUTILS_HH
 
 #include <string>
+#include <cstdlib>
+#include <new>
 using namespace std;
 
 namespace auxutils
 {
   //! \brief creates a string without file extension
   string remove_file_extension( const string& filename );
+
+  //! \brief allocator of memory aligned by 'A' bytes (cache line by
+  //! default) for contiguous arrays processed by vectorized loops
+  template< typename T, size_t A = 64 >
+  struct aligned_allocator
+  {
+    typedef T value_type;
+
+    template< typename U > struct rebind
+    {
+      typedef aligned_allocator< U, A > other;
+    };
+
+    aligned_allocator() {}
+    template< typename U >
+    aligned_allocator( const aligned_allocator< U, A >& ) {}
+
+    T* allocate( size_t n )
+    {
+      void* p = nullptr;
+      if( posix_memalign( &p, A, n * sizeof( T ) ) )
+        throw bad_alloc();
+      return static_cast< T* >( p );
+    }
+
+    void deallocate( T* p, size_t ) { free( p ); }
+  };
+
+  template< typename T, typename U, size_t A >
+  inline bool operator == ( const aligned_allocator< T, A >&,
+                            const aligned_allocator< U, A >& )
+  { return true; }
+
+  template< typename T, typename U, size_t A >
+  inline bool operator != ( const aligned_allocator< T, A >&,
+                            const aligned_allocator< U, A >& )
+  { return false; }
 }
 
 #endif      /* AUXUTILS_HH */
@@ -0,0 +1,209 @@
+/*!
+
+  \file bvtree.cc
+
+  \brief Implementation of bounding volume hierarchy
+
+*/
+
+#include <algorithm>
+
+#include "bvtree.hh"
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ local utils ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// part of element radius added to leaf box. Elements moving less than that
+// do not update the tree.
+static const double FAT_FACTOR = 0.25;
+
+// tight box of element`s bounding sphere
+inline BVTree::Box _box( const Element& e, double margin )
+{
+  double r = e.coll_r() + 0.5 * margin;
+  return { e.Glob - vec3d( r, r, r ), e.Glob + vec3d( r, r, r ) };
+}
+
+// box containing two boxes
+inline BVTree::Box _merge( const BVTree::Box& a, const BVTree::Box& b )
+{
+  return { vec3d( min( a.lo.x, b.lo.x ), min( a.lo.y, b.lo.y ),
+                  min( a.lo.z, b.lo.z ) ),
+           vec3d( max( a.hi.x, b.hi.x ), max( a.hi.y, b.hi.y ),
+                  max( a.hi.z, b.hi.z ) ) };
+}
+
+// exactly the same boxes
+inline bool _same( const BVTree::Box& a, const BVTree::Box& b )
+{
+  return a.lo == b.lo && a.hi == b.hi;
+}
+
+// fattened box
+inline BVTree::Box _fat( const BVTree::Box& b, double d )
+{
+  return { b.lo - vec3d( d, d, d ), b.hi + vec3d( d, d, d ) };
+}
+
+// =============================== Methods ==================================
+
+void BVTree::build( const ElementStore& es,
+                    const std::vector<size_t>& items, double margin )
+{
+  clear();
+  updates = 0;
+  if( items.empty() ) return;
+
+  ids = items;
+  std::sort( ids.begin(), ids.end() );
+  nodes.reserve( 2 * ids.size() );
+
+  std::vector<size_t> work( ids );
+  _build( work, 0, work.size(), es, margin );
+
+  // leaf index for each element in 'ids' order
+  leaf.assign( ids.size(), -1 );
+  for( size_t n = 0; n < nodes.size(); ++n )
+    if( nodes[n].left < 0 )
+      {
+        size_t k = std::lower_bound( ids.begin(), ids.end(), nodes[n].elem )
+                   - ids.begin();
+        leaf[k] = n;
+      }
+}
+
+//---------------------------------------------------------------------
+
+long BVTree::_build( std::vector<size_t>& items, size_t beg, size_t end,
+                     const ElementStore& es, double margin )
+{
+  long n = nodes.size();
+  nodes.push_back( Node() );
+
+  if( end - beg == 1 )
+    {
+      const Element& e = es[ items[beg] ];
+      nodes[n].elem = items[beg];
+      nodes[n].b = _fat( _box( e, margin ), FAT_FACTOR * e.sbb_rmin );
+      return n;
+    }
+
+  // split along the longest axis of centers` box by median
+  vec3d lo = es[ items[beg] ].Glob, hi = lo;
+  for( size_t i = beg + 1; i < end; ++i )
+    {
+      const vec3d& p = es[ items[i] ].Glob;
+      lo = vec3d( min( lo.x, p.x ), min( lo.y, p.y ), min( lo.z, p.z ) );
+      hi = vec3d( max( hi.x, p.x ), max( hi.y, p.y ), max( hi.z, p.z ) );
+    }
+  vec3d d = hi - lo;
+  int ax = ( d.x > d.y && d.x > d.z ) ? 0 : ( d.y > d.z ? 1 : 2 );
+
+  size_t mid = ( beg + end ) / 2;
+  std::nth_element( items.begin() + beg, items.begin() + mid,
+                    items.begin() + end,
+                    [&es, ax]( size_t a, size_t b )
+                    { return es[a].Glob[ax] < es[b].Glob[ax]; } );
+
+  long l = _build( items, beg, mid, es, margin );
+  long r = _build( items, mid, end, es, margin );
+
+  nodes[n].left = l;
+  nodes[n].right = r;
+  nodes[l].parent = n;
+  nodes[r].parent = n;
+  nodes[n].b = _merge( nodes[l].b, nodes[r].b );
+  return n;
+}
+
+//---------------------------------------------------------------------
+
+void BVTree::refit( const ElementStore& es, double margin )
+{
+  // leaves: only elements that have left their fat boxes, each followed by
+  // its ancestors until their boxes stop changing
+  for( size_t k = 0; k < ids.size(); ++k )
+    {
+      const Element& e = es[ ids[k] ];
+      Box b = _box( e, margin );
+      Node& nd = nodes[ leaf[k] ];
+
+      if( nd.b.contains( b ) ) continue;
+
+      nd.b = _fat( b, FAT_FACTOR * e.sbb_rmin );
+      ++updates;
+
+      for( long n = nd.parent; n >= 0; n = nodes[n].parent )
+        {
+          Box m = _merge( nodes[ nodes[n].left ].b,
+                          nodes[ nodes[n].right ].b );
+          if( _same( m, nodes[n].b ) ) break;
+          nodes[n].b = m;
+        }
+    }
+
+  // too many updates: the tree is probably loose - rebuild it
+  if( updates > ids.size() )
+    {
+      std::vector<size_t> items( ids );
+      build( es, items, margin );
+    }
+}
+
+//---------------------------------------------------------------------
+
+void BVTree::self_pairs( Pairs& res ) const
+{
+  if( nodes.size() ) _self( 0, res );
+}
+
+//---------------------------------------------------------------------
+
+void BVTree::pairs( const BVTree& t, Pairs& res ) const
+{
+  if( nodes.size() && t.nodes.size() )
+    _cross( *this, 0, t, 0, res );
+}
+
+//---------------------------------------------------------------------
+
+void BVTree::_self( long n, Pairs& res ) const
+{
+  const Node& nd = nodes[n];
+  if( nd.left < 0 ) return;
+
+  _self( nd.left, res );
+  _self( nd.right, res );
+  _cross( *this, nd.left, *this, nd.right, res );
+}
+
+//---------------------------------------------------------------------
+
+void BVTree::_cross( const BVTree& ta, long a, const BVTree& tb, long b,
+                     Pairs& res ) const
+{
+  const Node& na = ta.nodes[a];
+  const Node& nb = tb.nodes[b];
+
+  if( !na.b.overlaps( nb.b ) ) return;
+
+  bool la = na.left < 0, lb = nb.left < 0;
+
+  if( la && lb )
+    {
+      res.push_back( std::make_pair( na.elem, nb.elem ) );
+      return;
+    }
+
+  // descend into the node with larger box (or into the only internal one)
+  vec3d da = na.b.hi - na.b.lo, db = nb.b.hi - nb.b.lo;
+  if( lb || ( !la && abs2( da ) >= abs2( db ) ) )
+    {
+      _cross( ta, na.left, tb, b, res );
+      _cross( ta, na.right, tb, b, res );
+    }
+  else
+    {
+      _cross( ta, a, tb, nb.left, res );
+      _cross( ta, a, tb, nb.right, res );
+    }
+}
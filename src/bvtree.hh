@@ -0,0 +1,101 @@
+/*!
+
+  \file bvtree.hh
+
+  \brief Bounding volume hierarchy (binary tree of axis aligned boxes in
+  global (x, y, z) coordinates) over ice elements for contact detection.
+  Boxes of leaves are 'fat': they contain the element with some margin, so
+  slow elements do not change the tree at all and the tree is refitted
+  incrementally.
+
+*/
+
+#ifndef BVTREE_HH
+#define BVTREE_HH
+
+#include <vector>
+#include <utility>
+
+#include "siku.hh"
+#include "element.hh"
+
+//! \brief Dynamic bounding volume tree of elements
+class BVTree
+{
+public:
+  //! \brief axis aligned box
+  struct Box
+  {
+    vec3d lo, hi;
+
+    //! \brief check if two boxes overlap
+    inline bool overlaps( const Box& b ) const
+    {
+      return lo.x <= b.hi.x && b.lo.x <= hi.x &&
+             lo.y <= b.hi.y && b.lo.y <= hi.y &&
+             lo.z <= b.hi.z && b.lo.z <= hi.z;
+    }
+
+    //! \brief check if the box contains other box
+    inline bool contains( const Box& b ) const
+    {
+      return lo.x <= b.lo.x && b.hi.x <= hi.x &&
+             lo.y <= b.lo.y && b.hi.y <= hi.y &&
+             lo.z <= b.lo.z && b.hi.z <= hi.z;
+    }
+  };
+
+  //! \brief tree node. Leaves have no children and point to an element.
+  struct Node
+  {
+    Box b;
+    long left { -1 };     // children (-1 for leaves)
+    long right { -1 };
+    long parent { -1 };   // -1 for root
+    size_t elem { 0 };    // index of element in Globals.es (leaves only)
+  };
+
+  //! \brief pairs of elements` indexes
+  typedef std::vector< std::pair<size_t, size_t> > Pairs;
+
+  //! \brief builds the tree over listed elements (top-down median split)
+  //! \param[in] es all elements
+  //! \param[in] ids indexes of elements to put into the tree
+  //! \param[in] margin additional radius of elements` bounding spheres
+  void build( const ElementStore& es, const std::vector<size_t>& ids,
+              double margin );
+
+  //! \brief updates boxes of moved elements and their ancestors (walking
+  //! up from changed leaves while boxes change). Rebuilds the whole tree if
+  //! it has degraded (too many leaves were updated).
+  void refit( const ElementStore& es, double margin );
+
+  //! \brief collects pairs of elements with overlapping boxes inside the tree
+  void self_pairs( Pairs& res ) const;
+
+  //! \brief collects pairs of elements with overlapping boxes between this
+  //! tree and other one (first index is from this tree)
+  void pairs( const BVTree& t, Pairs& res ) const;
+
+  //! \brief number of elements in the tree
+  inline size_t size() const { return ids.size(); }
+
+  //! \brief drops the tree
+  inline void clear() { nodes.clear(); ids.clear(); leaf.clear(); }
+
+private:
+  std::vector<Node> nodes;      // nodes, parents have lower indexes
+  std::vector<size_t> ids;      // elements in the tree
+  std::vector<long> leaf;       // leaf node of each element in 'ids' order
+  size_t updates { 0 };         // leaves updated since last build
+
+  long _build( std::vector<size_t>& items, size_t beg, size_t end,
+               const ElementStore& es, double margin );
+
+  void _self( long n, Pairs& res ) const;
+
+  void _cross( const BVTree& ta, long a, const BVTree& tb, long b,
+               Pairs& res ) const;
+};
+
+#endif      /* BVTREE_HH */
@@ -31,36 +31,99 @@ using namespace Geometry;
 
 // ~~~~~~~~~~~~~~~~~~~~~ predeclarations  and inlines ~~~~~~~~~~~~~~~~~~~~~~~
 
-inline bool el_pointers_x_compare( Element* pe1, Element* pe2 );
-
 void add_cont( Globals& siku, const size_t& i1, const size_t& i2,
                const int& t );
 
-// merge lists of old and new contacts
-void merge_contacts( vector<ContactDetector::Contact>& olds,
-                     const vector<ContactDetector::Contact>& news );
+inline bool _sap_compare( const ContactDetector::SapEntry& s1,
+                          const ContactDetector::SapEntry& s2 );
+
+void _insertion_sort( vector<ContactDetector::SapEntry>& v );
+
+void _principal_axes( const ElementStore& es, const vec3d& guess,
+                      vec3d& ax1, vec3d& ax2 );
 
-void _freeze( ContactDetector::Contact& c, Globals& siku, double tol );
-void _share( ContactDetector::Contact& c, Globals& siku, double tol );
-void _dist_freeze( ContactDetector::Contact& c, Globals& siku, double tol );
+void _freeze( ContactDetector::Contact& c, ContactDetector::Bond& b,
+              Globals& siku, double tol );
+void _share( ContactDetector::Contact& c, ContactDetector::Bond& b,
+             Globals& siku, double tol );
+void _dist_freeze( ContactDetector::Contact& c, ContactDetector::Bond& b,
+                   Globals& siku, double tol );
 
-void _select_freeze( std::vector<ContactDetector::Contact>& cont,
+void _select_freeze( ContactDetector::ContactStore& cont,
                      Globals& siku, const double& tol );
 
 inline double _sqr( const double& x ) { return x*x; }
 
+// amount of outer loop iterations in one block of parallel detection. Fixed
+// (not depending on threads amount) for reproducible contacts order
+static const size_t DET_BLOCK = 256;
+
+// minimal cosine between old and new sweep axes to keep the old one
+static const double SAP_AXIS_TOLERANCE = 0.985;  // ~10 degrees
+
 inline double _dist2( const vec3d& v1, const vec3d& v2 )
 {
   return dot( v2 - v1, v2 - v1 );
 }
 
+// relative inflation of boxes and polygons in mid phase. Covers distortion
+// of shapes moved from one local frame into another
+static const double CASCADE_TOL = 1e-3;
+
+// e2 vertices in e1 local frame for mid phase polygons test (per thread)
+static thread_local vector<vec2d> mid_P2;
+
+// transforms point from local 2d frame of e2 into the one of e1
+inline vec2d _to_e1( const mat3d& e2_to_e1, const vec2d& p )
+{
+  return vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( p ) );
+}
+
+// checks if 'n' is a separating axis of two boxes (centers interposition
+// 'd', half-axes a1, b1, a2, b2) with 'pad' gap allowed
+inline bool _box_axis( const vec2d& n, const vec2d& d,
+                       const vec2d& a1, const vec2d& b1,
+                       const vec2d& a2, const vec2d& b2, double pad )
+{
+  return abs( dot( n, d ) ) > abs( dot( n, a1 ) ) + abs( dot( n, b1 ) )
+      + abs( dot( n, a2 ) ) + abs( dot( n, b2 ) ) + pad * n.abs();
+}
+
+// checks if edge of P at 'p' with outward normal 'n' separates P from Q
+// farther than 'pad' (in units of |n|)
+inline bool _edge_axis( const vec2d& p, const vec2d& n,
+                        const vector<vec2d>& Q, double pad )
+{
+  for( auto& q : Q )
+    if( dot( n, q - p ) <= pad ) return false;
+  return true;
+}
+
+// integer coordinates of a cell in uniform 3d grid (used by cell list)
+typedef ContactDetector::GridCell _Cell;
+
+// cell containing a point. 'h_rec' - reciprocal cell size
+inline _Cell _cell_of( const vec3d& p, const double& h_rec )
+{
+  return { long( floor( p.x * h_rec ) ), long( floor( p.y * h_rec ) ),
+           long( floor( p.z * h_rec ) ) };
+}
+
+// spatial hash of a cell (large primes, Teschner et al.)
+inline size_t _cell_hash( const _Cell& c )
+{
+  return size_t( c.x * 73856093L ) ^ size_t( c.y * 19349663L )
+       ^ size_t( c.z * 83492791L );
+}
+
 // =============================== Methods ==================================
 
 // For sorting watch
 // https://s-media-cache-ak0.pinimg.com/originals/5f/fc/42/5ffc4224b938d1fb0abee887e4add84b.jpg
 // Yet simple 'sort' from <algorithm> is used.
 
-double ContactDetector::Contact::find_edges( Globals& siku )
+double ContactDetector::Contact::find_edges( Globals& siku,
+                                             Bond& b ) const
 {
   if( !i1 && !i2 ) return 0.; // if no elements were set
 
@@ -70,8 +133,8 @@ double ContactDetector::Contact::find_edges( Globals& siku )
   bool first_found = false, second_found = false;
   double l1 =0, l2 =0;
 
-  mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-  mat3d e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+  mat3d e1_to_e2 = glm::transpose( e2_to_e1 );
   vec2d dump, r12 = vec3_to_vec2( e2_to_e1 * NORTH ),
               r21 = vec3_to_vec2( e1_to_e2 * NORTH );
 
@@ -86,8 +149,8 @@ double ContactDetector::Contact::find_edges( Globals& siku )
           && tv1 != tv2 )
         {
           l1 = (tv2 - tv1).abs();
-          v11 = ( i + e1.P.size() - 1 ) % e1.P.size(); // i-1`st
-          v12 = i;
+          b.v11 = ( i + e1.P.size() - 1 ) % e1.P.size(); // i-1`st
+          b.v12 = i;
           first_found = true;
           break;
         }
@@ -102,8 +165,8 @@ double ContactDetector::Contact::find_edges( Globals& siku )
           && tv1 != tv2 )
         {
           l2 = (tv2 - tv1).abs();
-          v21 = ( i + e1.P.size() - 1 ) % e1.P.size(); // i-1`st
-          v22 = i;
+          b.v21 = ( i + e1.P.size() - 1 ) % e1.P.size(); // i-1`st
+          b.v22 = i;
           second_found = true;
           break;
         }
@@ -120,113 +183,388 @@ double ContactDetector::Contact::find_edges( Globals& siku )
 // IMPROVE: remove code duplication in 'find_pairs'
 void ContactDetector::sweep_n_prune( Globals& siku )
 {
-  // preparing additional vector:
-  // setting pointers in supporting vector (for sortings, etc)
-  siku.pes.clear();
-  for( size_t i = 0; i < siku.es.size(); ++i )
-    siku.pes.push_back( &siku.es[i] );
+  bool resort = false;  // true if full sort is required
 
-  // sorting
-  std::sort( siku.pes.begin(), siku.pes.end(), el_pointers_x_compare );
+  // elements list has changed: new entries in original order
+  if( sap.size() != siku.es.size() )
+    {
+      sap.resize( siku.es.size() );
+      for( size_t i = 0; i < sap.size(); ++i )
+        sap[i].i = i;
+      resort = true;
+    }
 
-  // IMPROVE: need to create empty vector of instantly large capacity
-  static std::vector<ContactDetector::Contact> news;
+  // principal directions of the pack. Sweep axis is changed only if it has
+  // turned significantly: that keeps the order coherent between calls
+  vec3d ax1, ax2;
+  _principal_axes( siku.es, sap_ax1, ax1, ax2 );
 
-  // contact search
-  for ( size_t i = 0; i < siku.pes.size () - 1; ++i )
+  if( abs( dot( ax1, sap_ax1 ) ) < SAP_AXIS_TOLERANCE )
     {
-      if( siku.pes[i]->flag & Element::F_ERRORED ) continue;
+      sap_ax1 = ax1;
+      resort = true;
+    }
+  sap_ax2 = ort( ax2 - sap_ax1 * dot( ax2, sap_ax1 ) );
+
+  // refreshing endpoints
+  for( auto& s : sap )
+    {
+      Element& e = siku.es[ s.i ];
+      double c1 = dot( e.Glob, sap_ax1 );
+      double r = e.coll_r() + 0.5 * det_margin;  // inflated radius
+
+      s.r = ( e.flag & Element::F_ERRORED ) ? -1. : r;
+      s.lo = c1 - r;
+      s.hi = c1 + r;
+      s.c2 = dot( e.Glob, sap_ax2 );
+    }
 
-      for ( size_t j = i + 1; j < siku.pes.size (); ++j )
+  // sorting: insertion sort is close to O(N) for nearly sorted array
+  if( resort )
+    std::sort( sap.begin(), sap.end(), _sap_compare );
+  else
+    _insertion_sort( sap );
+
+  // contact search (in parallel by blocks of sweep range)
+  const size_t nb = news_open( sap.size() );
+
+#pragma omp parallel for schedule(dynamic)
+  for( size_t b = 0; b < nb; ++b )
+    {
+      auto& nw = news[b];
+      auto& st = news_st[b];
+      const size_t iend = std::min( sap.size(), ( b + 1 ) * DET_BLOCK );
+
+      for ( size_t i = b * DET_BLOCK; i < iend; ++i )
         {
-          if( siku.pes[j]->flag & Element::F_ERRORED ) continue;
+          const SapEntry& si = sap[i];
+          if( si.r < 0. ) continue;  // errored
 
-          if ( _dist2( siku.pes[i]->Glob, siku.pes[j]->Glob ) <
-              _sqr( siku.pes[i]->sbb_rmin + siku.pes[j]->sbb_rmin ) )
+          for ( size_t j = i + 1; j < sap.size () && sap[j].lo <= si.hi; ++j )
             {
-              //// deprecated
-              //add_cont( siku, siku.pes[i]->id, siku.pes[j]->id,
-              //          siku.time.get_n () );
+              const SapEntry& sj = sap[j];
+              if( sj.r < 0. ) continue;
+
+              // pruning on second axis
+              if( abs( si.c2 - sj.c2 ) > si.r + sj.r ) continue;
 
-              news.push_back( ContactDetector::Contact( siku.pes[i]->id,
-                    siku.pes[j]->id, siku.time.get_n(), NONE ) );
+              if ( mid_phase( siku.es[ si.i ], siku.es[ sj.i ], st ) )
+                {
+                  nw.push_back( ContactDetector::Contact( si.i, sj.i,
+                                                  siku.time.get_n(), NONE ) );
+                }
             }
-          // should not this be placed in loop condition check?
-          if ( (siku.pes[i]->Glob.x + siku.pes[i]->sbb_rmin) <
-              (siku.pes[j]->Glob.x - siku.pes[j]->sbb_rmin) )
+        }
+    }
+
+  news_merge();
+}
 
-              break;
+//---------------------------------------------------------------------
 
+void ContactDetector::find_pairs( Globals& siku )
+{
+  const size_t nb = news_open( siku.es.size() );
+
+#pragma omp parallel for schedule(dynamic)
+  for( size_t b = 0; b < nb; ++b )
+    {
+      auto& nw = news[b];
+      auto& st = news_st[b];
+      const size_t iend = std::min( siku.es.size(), ( b + 1 ) * DET_BLOCK );
+
+      for ( size_t i = b * DET_BLOCK; i < iend; ++i )
+        {
+          for ( size_t j = i + 1; j < siku.es.size (); ++j )
+            {
+              if ( mid_phase( siku.es[i], siku.es[j], st ) )
+                nw.push_back( ContactDetector::Contact( i, j,
+                                                siku.time.get_n(), NONE ) );
+            }
         }
     }
 
-  std::sort( news.begin(), news.end() );
+  news_merge();
+}
+
+//---------------------------------------------------------------------
+
+void ContactDetector::cell_list( Globals& siku )
+{
+  auto& cells = cl_cells;
+  auto& head = cl_head;
+  auto& next = cl_next;
+
+  const size_t size = siku.es.size();
+
+  // cell size: no pair can be farther than two largest bounding radii
+  double rmax = 0.;
+  for( auto& e : siku.es )
+    if( !( e.flag & Element::F_ERRORED ) && e.coll_r() > rmax )
+      rmax = e.coll_r();
+
+  rmax += 0.5 * det_margin;  // inflated radius (for Verlet lists)
 
-  merge_contacts( siku.ConDet.cont, news );
+  // degenerated case (all points): any nonzero size is fine
+  double h_rec = rmax > 0. ? 0.5 / rmax : 1.;
+
+  // hash table of power of two size (at least twice the elements amount)
+  size_t hsize = 1;
+  while( hsize < 2 * size ) hsize <<= 1;
+  const size_t mask = hsize - 1;
+
+  head.assign( hsize, -1 );
+  next.resize( size );
+  cells.resize( size );
+
+  // binning
+  for( size_t i = 0; i < size; ++i )
+    {
+      if( siku.es[i].flag & Element::F_ERRORED ) continue;
+
+      cells[i] = _cell_of( siku.es[i].Glob, h_rec );
+
+      size_t b = _cell_hash( cells[i] ) & mask;
+      next[i] = head[b];
+      head[b] = i;
+    }
 
-  news.clear();  // should be O(1) without deallocation
+  // contact search: each element looks through 27 neighbouring cells.
+  // Parallel by blocks of elements
+  const size_t nb = news_open( size );
+
+#pragma omp parallel for schedule(dynamic)
+  for( size_t b = 0; b < nb; ++b )
+    {
+      auto& nw = news[b];
+      auto& st = news_st[b];
+      const size_t iend = std::min( size, ( b + 1 ) * DET_BLOCK );
+
+      for( size_t i = b * DET_BLOCK; i < iend; ++i )
+        {
+          if( siku.es[i].flag & Element::F_ERRORED ) continue;
+
+          for( long dx = -1; dx <= 1; ++dx )
+            for( long dy = -1; dy <= 1; ++dy )
+              for( long dz = -1; dz <= 1; ++dz )
+                {
+                  _Cell nc { cells[i].x + dx, cells[i].y + dy,
+                             cells[i].z + dz };
+
+                  for( long j = head[ _cell_hash( nc ) & mask ]; j >= 0;
+                       j = next[j] )
+                    {
+                      // each pair once and only from its real cell
+                      // (different cells may share the same bucket)
+                      if( size_t( j ) <= i || !( cells[j] == nc ) ) continue;
+
+                      if ( mid_phase( siku.es[i], siku.es[j], st ) )
+                        nw.push_back( ContactDetector::Contact( i, j,
+                              siku.time.get_n(), NONE ) );
+                    }
+                }
+        }
+    }
+
+  news_merge();
 }
 
 //---------------------------------------------------------------------
 
-void ContactDetector::find_pairs( Globals& siku )
+void ContactDetector::bv_tree( Globals& siku )
 {
-  // IMPROVE: need to create empty vector of instantly large capacity
-  static std::vector<ContactDetector::Contact> news;
+  auto& pairs = bvt_pairs;
 
-  for ( size_t i = 0; i < siku.es.size () - 1; ++i )
+  // elements list has changed: building both trees from scratch
+  if( bvt_size != siku.es.size() )
     {
-      for ( size_t j = i + 1; j < siku.es.size (); ++j )
+      std::vector<size_t> dyn, stat;
+      for( size_t i = 0; i < siku.es.size(); ++i )
         {
-          if ( _dist2( siku.es[i].Glob, siku.es[j].Glob ) <
-              _sqr( siku.es[i].sbb_rmin + siku.es[j].sbb_rmin ) )
-            add_cont( siku, i, j, siku.time.get_n() );
+          if( siku.es[i].flag & Element::F_ERRORED ) continue;
+
+          if( siku.es[i].flag & Element::F_STATIC )
+            stat.push_back( i );
+          else
+            dyn.push_back( i );
         }
+
+      bvt_dyn.build( siku.es, dyn, det_margin );
+      bvt_stat.build( siku.es, stat, det_margin );
+      bvt_size = siku.es.size();
     }
+  else
+    bvt_dyn.refit( siku.es, det_margin );
 
-  std::sort( news.begin(), news.end() );
+  // candidates: moving VS moving and moving VS static
+  bvt_dyn.self_pairs( pairs );
+  bvt_dyn.pairs( bvt_stat, pairs );
 
-  merge_contacts( siku.ConDet.cont, news );
+  // exact test of candidates (tree traversal itself is sequential)
+  const size_t nb = news_open( pairs.size() );
+
+#pragma omp parallel for schedule(static)
+  for( size_t b = 0; b < nb; ++b )
+    {
+      auto& nw = news[b];
+      auto& st = news_st[b];
+      const size_t kend = std::min( pairs.size(), ( b + 1 ) * DET_BLOCK );
 
-  news.clear();  // should be O(1) without deallocation
+      for( size_t k = b * DET_BLOCK; k < kend; ++k )
+        {
+          const size_t i1 = pairs[k].first, i2 = pairs[k].second;
+          const Element& e1 = siku.es[ i1 ], & e2 = siku.es[ i2 ];
+
+          if( ( e1.flag | e2.flag ) & Element::F_ERRORED ) continue;
+
+          if ( mid_phase( e1, e2, st ) )
+            nw.push_back( ContactDetector::Contact( i1, i2,
+                                                    siku.time.get_n(), NONE ) );
+        }
+    }
+  pairs.clear();
+
+  news_merge();
 }
 
 // --------------------------------------------------------------------------
 
-void ContactDetector::clear()
+size_t ContactDetector::news_open( size_t n )
 {
-  size_t size = cont.size();
-  for( size_t i = 0; i < size; ++i )
+  const size_t nb = ( n + DET_BLOCK - 1 ) / DET_BLOCK;
+
+  // buffers are only added, so their capacity is reused between calls
+  if( news.size() < nb )
+    news.resize( nb );
+
+  news_st.assign( news.size(), CascadeStats() );
+
+  return nb;
+}
+
+// --------------------------------------------------------------------------
+
+void ContactDetector::news_merge()
+{
+  // sequential in blocks` order: the same contacts order with any amount
+  // of threads. Existing contacts (with all their state) remain untouched
+  for( auto& nw : news )
     {
-      if( cont[i].type == ContType::JOINT )  // joints untouched
+      for( auto& c : nw )
+        cont.insert( c );
+      nw.clear();  // should be O(1) without deallocation
+    }
+
+  for( auto& st : news_st )
+    {
+      cstats.cap += st.cap;
+      cstats.obb += st.obb;
+      cstats.poly += st.poly;
+      cstats.passed += st.passed;
+    }
+}
+
+// --------------------------------------------------------------------------
+
+bool ContactDetector::mid_phase( const Element& e1, const Element& e2,
+                                 CascadeStats& st ) const
+{
+  // bounding caps
+  if ( _dist2( e1.Glob, e2.Glob ) >=
+      _sqr( e1.coll_r() + e2.coll_r() + det_margin ) )
+    {
+      ++st.cap;
+      return false;
+    }
+
+  if( det_cascade >= CASCADE_OBB )
+    {
+      // both boxes in e1 local frame
+      mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+
+      vec2d c2 = _to_e1( e2_to_e1, e2.obb_c ),
+            a2 = _to_e1( e2_to_e1, e2.obb_c + e2.obb_a ) - c2,
+            b2 = _to_e1( e2_to_e1, e2.obb_c + e2.obb_b ) - c2,
+            d = c2 - e1.obb_c;
+
+      double pad = det_margin + CASCADE_TOL * ( e1.r2 + e2.r2 );
+
+      if( _box_axis( rot_90_ccw( e1.obb_a ), d, e1.obb_a, e1.obb_b, a2, b2,
+                     pad ) ||
+          _box_axis( rot_90_ccw( e1.obb_b ), d, e1.obb_a, e1.obb_b, a2, b2,
+                     pad ) ||
+          _box_axis( rot_90_ccw( a2 ), d, e1.obb_a, e1.obb_b, a2, b2, pad ) ||
+          _box_axis( rot_90_ccw( b2 ), d, e1.obb_a, e1.obb_b, a2, b2, pad ) )
         {
-          if( cont[i].durability < 0.05 )  // destruction
-            {
-              //cout<<"CRACK!"<<endl;
-              cont[i].type = ContType::COLLISION;
-              cont[i].generation = 0;
-            }
+          ++st.obb;
+          return false;
         }
-      else  // deleting contact
+
+      if( det_cascade >= CASCADE_POLY )
         {
-          if( cont[i].generation > 1 )  // IMPROVE
+          // collision polygons (proxies if they are used)
+          const vector<vec2d>& P1 = e1.coll(), & N1 = e1.coll_n();
+
+          mid_P2.clear();
+          for( auto& p : e2.coll() )
+            mid_P2.push_back( _to_e1( e2_to_e1, p ) );
+
+          bool sep = false;
+          for( size_t k = 0; !sep && k < P1.size(); ++k )
+            sep = _edge_axis( P1[k], N1[k], mid_P2, pad );
+
+          for( size_t j = 0; !sep && j < mid_P2.size(); ++j )
             {
-              cont[i] = cont[--size];  // replacing current with last
-              cont.pop_back();         // and deleting last
+              const vec2d& q = mid_P2[j];
+              vec2d n = rot_90_cw( mid_P2[ ( j + 1 ) % mid_P2.size() ] - q );
+              sep = _edge_axis( q, n, P1, pad * n.abs() );
+            }
+
+          if( sep )
+            {
+              ++st.poly;
+              return false;
             }
-          else
-            cont[i].generation++;
         }
     }
 
-  // sorting of remains. Required by contact_exist check
-  std::sort( cont.begin(), cont.end() );
+  ++st.passed;
+  return true;
+}
+
+// --------------------------------------------------------------------------
+
+void ContactDetector::clear()
+{
+  // deleting (or aging) of not-joint contacts
+  for( size_t i = cont.joints(); i < cont.size(); )
+    {
+      if( cont[i].generation > 1 )  // IMPROVE
+        cont.erase( i );  // replaced by last - same 'i' must be checked
+      else
+        cont[i++].generation++;
+    }
+
+  // joints remain untouched until destroyed
+  for( size_t i = 0; i < cont.joints(); )
+    {
+      if( cont.bond(i).durability < 0.05 )  // destruction
+        {
+          //cout<<"CRACK!"<<endl;
+          cont[i].generation = 0;
+          cont.set_type( i, ContType::COLLISION );  // other joint takes 'i'
+        }
+      else
+        ++i;
+    }
 }
 
 //---------------------------------------------------------------------
 
 void ContactDetector::detect( Globals& siku )
 {
+  cstats = CascadeStats();
+
   // elements amount check: less then 2 - contacts are impossible
   if( siku.es.size() < 2 || !is_detect_time( siku ) )
     return;
@@ -244,6 +582,12 @@ void ContactDetector::detect( Globals& siku )
     case SWEEP_N_PRUNE:
       sweep_n_prune( siku );
       break;
+    case CELL_LIST:
+      cell_list( siku );
+      break;
+    case BV_TREE:
+      bv_tree( siku );
+      break;
   }
 }
 
@@ -254,11 +598,16 @@ void ContactDetector::freeze( Globals& siku, double tol )
   // everything must be cleared
   cont.clear();
 
-  // preparatory detection
+  // preparatory detection. Elements are resized by 'tol' for freezing, so
+  // touching pairs must not be rejected by mid phase
+  unsigned long casc = det_cascade;
+  det_cascade = CASCADE_CAP;
   detect( siku );
+  det_cascade = casc;
 
   // actual freezing
   _select_freeze( cont, siku, tol );
+  cont.repartition();
 
 //  switch( siku.cont_force_model )
 //  {
@@ -287,15 +636,38 @@ void ContactDetector::freeze_links( Globals& siku )
 {
   cont.clear();
 
+  // links are set by elements` ids
   for( auto& a : links )
-    cont.push_back( Contact( a.i1, a.i2, 0, JOINT ) );
-
-  std::sort( cont.begin(), cont.end() );
+    cont.insert( Contact( siku.slot[ a.i1 ], siku.slot[ a.i2 ], 0, JOINT ) );
 
 //  for( auto& c : cont )
 //    _freeze( c, siku, 0.1 );
   _select_freeze( cont, siku, 0.1 );
+  cont.repartition();
+
+}
+
+// --------------------------------------------------------------------------
+
+void ContactDetector::renumber( const std::vector<size_t>& new_slot )
+{
+  cont.renumber( new_slot );
 
+  // sweep and prune order remains valid: only indexes are changed
+  for( auto& s : sap )
+    s.i = new_slot[ s.i ];
+
+  // Verlet lists positions follow their elements
+  if( det_pos.size() == new_slot.size() )
+    {
+      std::vector<vec3d> t( det_pos.size() );
+      for( size_t i = 0; i < det_pos.size(); ++i )
+        t[ new_slot[i] ] = det_pos[i];
+      det_pos.swap( t );
+    }
+
+  // trees are rebuilt at next detection
+  bvt_size = 0;
 }
 
 // --------------------------------------------------------------------------
@@ -304,10 +676,10 @@ bool ContactDetector::is_detect_time( Globals& siku )
 {
   switch( det_freq_t )
   {
-    case 0:  // always
+    case ALWAYS:
       //return true; // same as default
       break;
-    case 1:  // by ticks
+    case BY_TICKS:
       if( siku.time.get_n() > size_t( det_last + det_value ) )
         {
           det_last = siku.time.get_n();
@@ -315,7 +687,7 @@ bool ContactDetector::is_detect_time( Globals& siku )
         }
       return false;
       break;
-    case 2:  // by seconds
+    case BY_SECONDS:
       if( (double)siku.time.get_total_microseconds() * 0.000001 >
           det_last + det_value )
         {
@@ -324,148 +696,371 @@ bool ContactDetector::is_detect_time( Globals& siku )
         }
       return false;
       break;
-    case 3:  // by speed (automatic)
-
-      // searching max p speed
-      double maxs = 0;
-      for( auto& e : siku.es )
-        if( abs2( e.V ) > maxs ) maxs = abs2( e.V );
-      maxs = sqrt( maxs );
-
-      det_last += siku.time.get_dt() * maxs;  // accumulate displacement
-
-      if( det_last > det_value )
-        {
-          det_last = 0.;
-          return true;
-        }
-      return false;
+    case BY_SPEED:  // by speed (automatic)
+      {
+        // searching max p speed
+        double maxs = 0;
+        for( auto& V : siku.es.V )
+          if( abs2( V ) > maxs ) maxs = abs2( V );
+        maxs = sqrt( maxs );
+
+        det_last += siku.time.get_dt() * maxs;  // accumulate displacement
+
+        if( det_last > det_value )
+          {
+            det_last = 0.;
+            return true;
+          }
+        return false;
+      }
+      break;
+    case BY_SKIN:  // Verlet lists
+      {
+        // pairs are listed with inflated bounding spheres: sum of radii
+        // plus skin. The list remains valid until any element moves more
+        // than half of the skin.
+        det_margin = det_value * siku.planet.R_rec;
+        double lim2 = _sqr( 0.5 * det_margin );
+
+        bool rebuild = det_pos.size() != siku.es.size();
+        for( size_t i = 0; !rebuild && i < siku.es.size(); ++i )
+          rebuild = _dist2( siku.es[i].Glob, det_pos[i] ) > lim2;
+
+        if( rebuild )
+          {
+            det_pos.resize( siku.es.size() );
+            for( size_t i = 0; i < siku.es.size(); ++i )
+              det_pos[i] = siku.es[i].Glob;
+            return true;
+          }
+        return false;
+      }
       break;
   }
   return true;
 }
 
-// ============================ Local utilities =============================
+// ============================= Contacts store =============================
 
-// comparator for sorting algorithm
-inline bool elements_x_compare( const Element& e1, const Element& e2 )
+// bits mixing for hash (splitmix64 finalizer)
+inline size_t _mix( uint64_t k )
 {
-  /*
-   * TODO: i think we should calculate xmin and xmax on update phase and store
-   * inside each element, rather then calculate several times in one check!
-   */
-  return (e1.Glob.x - e1.sbb_rmin) < (e2.Glob.x - e2.sbb_rmin);
+  k ^= k >> 30;  k *= 0xbf58476d1ce4e5b9ULL;
+  k ^= k >> 27;  k *= 0x94d049bb133111ebULL;
+  k ^= k >> 31;
+  return size_t( k );
 }
 
 // --------------------------------------------------------------------------
 
-// pointer comparator for sorting algorithm
-inline bool el_pointers_x_compare( Element* pe1, Element* pe2 )
+size_t ContactDetector::ContactStore::_probe( uint64_t key ) const
 {
-  return elements_x_compare( *pe1, * pe2 );
-  //return (pe1->Glob.x - pe1->sbb_rmin) < (pe2->Glob.x - pe2->sbb_rmin);
+  size_t b = _mix( key ) & mask;
+  while( table[b].key != EMPTY && table[b].key != key )
+    b = ( b + 1 ) & mask;
+  return b;
 }
 
 // --------------------------------------------------------------------------
 
-void merge_contacts( vector<ContactDetector::Contact>& olds,
-                     const vector<ContactDetector::Contact>& news )
+void ContactDetector::ContactStore::_rehash( size_t capacity )
 {
-  static std::vector<ContactDetector::Contact> temp;
-  temp.clear();
-  size_t oi = 0, ni = 0;
+  table.assign( capacity, Bucket{ EMPTY, 0 } );
+  mask = capacity - 1;
 
-  while( true ) //oi < olds.size() || ni < news.size() )
+  for( size_t k = 0; k < items.size(); ++k )
     {
-      // IMPROVE: remove unnecessary conditions
-      if( ni < news.size() )
-        {
+      uint64_t key = _key( items[k] );
+      table[ _probe( key ) ] = Bucket{ key, k };
+    }
+}
 
-          if( oi < olds.size() )
-            {
-              if( news[ni] < olds[oi] )
-                temp.push_back( news[ni++] );
+// --------------------------------------------------------------------------
 
-              else if( olds[oi] < news[ni] )
-                temp.push_back( olds[oi++] );
+// deletion with backward shift (no tombstones in linear probing)
+void ContactDetector::ContactStore::_remove_key( uint64_t key )
+{
+  size_t i = _probe( key );
+  if( table[i].key == EMPTY ) return;
 
-              else // <=> equal contacts
-                {
-                  temp.push_back( olds[oi++] );
-                  ni++;
-                }
-            }
-          else
-            temp.push_back( news[ni++] );
+  table[i].key = EMPTY;
+  for( size_t j = ( i + 1 ) & mask; table[j].key != EMPTY;
+       j = ( j + 1 ) & mask )
+    {
+      size_t h = _mix( table[j].key ) & mask;  // 'home' bucket of j-th key
 
-        }
-      else if( oi < olds.size() )
-        temp.push_back( olds[oi++] );
+      // bucket j may be moved to i only if its home is not in (i, j]
+      bool stays = ( i <= j ) ? ( i < h && h <= j ) : ( i < h || h <= j );
+      if( stays ) continue;
 
-      else
-        break; // instead of 'while' args
+      table[i] = table[j];
+      table[j].key = EMPTY;
+      i = j;
+    }
+}
+
+// --------------------------------------------------------------------------
 
+void ContactDetector::ContactStore::_move( size_t from, size_t to )
+{
+  if( from == to ) return;
+  items[to] = items[from];
+  bonds[to] = bonds[from];
+  table[ _probe( _key( items[to] ) ) ].pos = to;
+}
+
+// --------------------------------------------------------------------------
+
+ContactDetector::Contact*
+ContactDetector::ContactStore::find( size_t i1, size_t i2 )
+{
+  if( items.empty() ) return nullptr;
+
+  const Bucket& b = table[ _probe( _key( i1, i2 ) ) ];
+  return b.key == EMPTY ? nullptr : &items[ b.pos ];
+}
+
+// --------------------------------------------------------------------------
+
+bool ContactDetector::ContactStore::insert( const Contact& c, const Bond& b )
+{
+  // load factor is kept below 1/2
+  if( 2 * ( items.size() + 1 ) > table.size() )
+    _rehash( table.size() ? 2 * table.size() : 64 );
+
+  uint64_t key = _key( c );
+  size_t i = _probe( key );
+  if( table[i].key != EMPTY ) return false;  // already exists
+
+  table[i] = Bucket{ key, items.size() };
+  items.push_back( c );
+  bonds.push_back( b );
+
+  if( c.type == ContType::JOINT )  // moving to joints` group
+    {
+      Contact t = items.back();
+      Bond tb = bonds.back();
+      _move( nj, items.size() - 1 );
+      items[ nj ] = t;
+      bonds[ nj ] = tb;
+      table[ _probe( key ) ].pos = nj;
+      ++nj;
     }
 
-  temp.swap( olds );  // now siku.ConDet.conts must be refreshed list
+  return true;
+}
+
+// --------------------------------------------------------------------------
 
-  temp.clear();  // if all is correct - size will be 0, but no deallocation
-                 // would be called
+void ContactDetector::ContactStore::erase( size_t k )
+{
+  _remove_key( _key( items[k] ) );
+
+  if( k < nj )  // last joint takes the place, last contact takes its place
+    {
+      _move( nj - 1, k );
+      _move( items.size() - 1, nj - 1 );
+      --nj;
+    }
+  else
+    _move( items.size() - 1, k );
+
+  items.pop_back();
+  bonds.pop_back();
 }
 
 // --------------------------------------------------------------------------
 
-// quick check if such contact already exists. Assume that contacts list is
-// sorted with 'cont_compare'
-bool contact_exists( const ContactDetector& CD,
-                     const size_t& i1, const size_t& i2 )
+void ContactDetector::ContactStore::set_type( size_t k, ContType t )
 {
-  size_t i = 0;
+  bool was_joint = k < nj;
+  items[k].type = t;
 
-  // search first contact with matching i1
-  if( CD.cont.size() )  // if list exists at all
-    while( CD.cont[i].i1 < i1 )
-      if( ++i >= CD.cont.size() )  return false;
+  if( was_joint && t != ContType::JOINT )  // swapping with last joint
+    {
+      Contact c = items[k];
+      Bond b = bonds[k];
+      _move( nj - 1, k );
+      items[ nj - 1 ] = c;
+      bonds[ nj - 1 ] = b;
+      table[ _probe( _key( c ) ) ].pos = nj - 1;
+      --nj;
+    }
+  else if( !was_joint && t == ContType::JOINT )  // swapping with first other
+    {
+      Contact c = items[k];
+      Bond b = bonds[k];
+      _move( nj, k );
+      items[ nj ] = c;
+      bonds[ nj ] = b;
+      table[ _probe( _key( c ) ) ].pos = nj;
+      ++nj;
+    }
+}
+
+// --------------------------------------------------------------------------
 
-  // check if any contact matches by both indexes
-  for(; i < CD.cont.size() && CD.cont[i].i1 == i1; ++i )
-    if( CD.cont[i].i2 == i2 )  return true;
+void ContactDetector::ContactStore::repartition()
+{
+  // stable: relative order inside groups is preserved. Contacts and bonds
+  // are permuted together
+  std::vector<size_t> order( items.size() );
+  for( size_t k = 0; k < order.size(); ++k ) order[k] = k;
+
+  auto mid = std::stable_partition( order.begin(), order.end(),
+                                    [this]( size_t k )
+                                    { return items[k].type == JOINT; } );
+  nj = mid - order.begin();
+
+  std::vector<Contact> ti( items.size() );
+  std::vector<Bond> tb( bonds.size() );
+  for( size_t k = 0; k < order.size(); ++k )
+    {
+      ti[k] = items[ order[k] ];
+      tb[k] = bonds[ order[k] ];
+    }
+  items.swap( ti );
+  bonds.swap( tb );
 
-  return false;
+  _rehash( table.size() ? table.size() : 64 );
 }
 
 // --------------------------------------------------------------------------
 
-// add new contact to list with type checks
-void add_cont( Globals& siku, const size_t& i1, const size_t& i2, const int& t )
+void ContactDetector::ContactStore::renumber(
+    const std::vector<size_t>& new_slot )
+{
+  // orientation of contacts (which element is the first) is kept
+  for( auto& c : items )
+    {
+      c.i1 = new_slot[ c.i1 ];
+      c.i2 = new_slot[ c.i2 ];
+    }
+
+  if( table.size() ) _rehash( table.size() );
+}
+
+// --------------------------------------------------------------------------
+
+void ContactDetector::ContactStore::clear()
+{
+  items.clear();
+  bonds.clear();
+  nj = 0;
+  if( table.size() ) _rehash( table.size() );
+}
+
+// ============================ Local utilities =============================
+
+// comparator for sweep and prune entries
+inline bool _sap_compare( const ContactDetector::SapEntry& s1,
+                          const ContactDetector::SapEntry& s2 )
+{
+  return s1.lo < s2.lo;
+}
+
+// --------------------------------------------------------------------------
+
+// insertion sort of sweep and prune entries. Near O(N) on almost sorted data
+// (elements move just a bit between detections)
+void _insertion_sort( vector<ContactDetector::SapEntry>& v )
 {
-  if( !contact_exists( siku.ConDet, i1, i2 ) )
+  for( size_t i = 1; i < v.size(); ++i )
+    {
+      if( !_sap_compare( v[i], v[i-1] ) ) continue;
+
+      ContactDetector::SapEntry t = v[i];
+      size_t j = i;
+      for( ; j > 0 && _sap_compare( t, v[j-1] ); --j )
+        v[j] = v[j-1];
+      v[j] = t;
+    }
+}
+
+// --------------------------------------------------------------------------
+
+// two principal directions of elements` positions (largest and second
+// largest spreads) by power iterations on covariance matrix. 'guess' is used
+// as a starting vector for faster convergence.
+void _principal_axes( const ElementStore& es, const vec3d& guess,
+                      vec3d& ax1, vec3d& ax2 )
+{
+  static const int ITERATIONS = 16;
+
+  // mean
+  vec3d m {};
+  for( auto& e : es ) m += e.Glob;
+  m /= double( es.size() );
+
+  // covariance (symmetric, glm is column-major but it does not matter)
+  mat3d C( 0. );
+  for( auto& e : es )
+    {
+      vec3d d = e.Glob - m;
+      for( int k = 0; k < 3; ++k )
+        for( int l = 0; l < 3; ++l )
+          C[k][l] += d[k] * d[l];
+    }
+
+  ax1 = abs2( guess ) > 0. ? guess : vec3d( 1., 0., 0. );
+  for( int k = 0; k < ITERATIONS; ++k )
     {
-      siku.ConDet.cont.push_back ( ContactDetector::Contact ( i1, i2, t ) );
+      vec3d t = C * ax1;
+      if( abs2( t ) == 0. ) break;  // all elements are in one point
+      ax1 = ort( t );
     }
+
+  // second direction: same iterations in plane orthogonal to the first one
+  ax2 = cross( ax1, abs( ax1.x ) < 0.9 ? vec3d( 1., 0., 0. )
+                                        : vec3d( 0., 1., 0. ) );
+  ax2 = ort( ax2 );
+  for( int k = 0; k < ITERATIONS; ++k )
+    {
+      vec3d t = C * ax2;
+      t -= ax1 * dot( t, ax1 );
+      if( abs2( t ) == 0. ) break;
+      ax2 = ort( t );
+    }
+}
+
+// --------------------------------------------------------------------------
+
+// quick check if such contact already exists
+bool contact_exists( ContactDetector& CD,
+                     const size_t& i1, const size_t& i2 )
+{
+  return CD.cont.find( i1, i2 ) != nullptr;
+}
+
+// --------------------------------------------------------------------------
+
+// add new contact to list with type checks
+void add_cont( Globals& siku, const size_t& i1, const size_t& i2, const int& t )
+{
+  siku.ConDet.cont.insert( ContactDetector::Contact ( i1, i2, t ) );
 }
 
 // --------------------------------------------------------------------------
 
-void _select_freeze( std::vector<ContactDetector::Contact>& cont,
+void _select_freeze( ContactDetector::ContactStore& cont,
                      Globals& siku, const double& tol )
 {
   switch( siku.cont_force_model )
   {
     case CF_DEFAULT : // same as CF_TEST_SPRINGS
-      for( auto& c : cont )
-        _freeze( c, siku, tol );
+      for( size_t k = 0; k < cont.size(); ++k )
+        _freeze( cont[k], cont.bond(k), siku, tol );
       break;
 
     case CF_HOPKINS :
-      for( auto& c : cont )
-        _freeze( c, siku, tol );
-        //_share( c, siku, tol );
+      for( size_t k = 0; k < cont.size(); ++k )
+        _freeze( cont[k], cont.bond(k), siku, tol );
+        //_share( cont[k], cont.bond(k), siku, tol );
       break;
 
     case CF_DIST_SPRINGS :
-      for( auto& c : cont )
-        _dist_freeze( c, siku, tol );
+      for( size_t k = 0; k < cont.size(); ++k )
+        _dist_freeze( cont[k], cont.bond(k), siku, tol );
       break;
   }
 }
@@ -476,7 +1071,8 @@ void _select_freeze( std::vector<ContactDetector::Contact>& cont,
 // perform freezing on two elements by contact
 // implementation copied from 'contact_force'
 // TODO: move to 'geometric' module
-void _freeze( ContactDetector::Contact& c, Globals& siku, double tol )
+void _freeze( ContactDetector::Contact& c, ContactDetector::Bond& b,
+              Globals& siku, double tol )
 {
   Element &e1 = siku.es[c.i1], &e2 = siku.es[c.i2];
   int ires;  // !static? temporal variable to store geometry results
@@ -497,9 +1093,9 @@ void _freeze( ContactDetector::Contact& c, Globals& siku, double tol )
 //        return ei==2 && vi ==2;
 //      };
 
-  mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
       // !static
-  mat3d dest_to_src = loc_to_loc_mat( e2.q, e1.q );
+  mat3d dest_to_src = glm::transpose( e2_to_e1 );
       // !static
 
   //vec2d r2 = - vec3_to_vec2( dest_to_src * NORTH ); //TODO: select correct
@@ -515,33 +1111,34 @@ void _freeze( ContactDetector::Contact& c, Globals& siku, double tol )
       //&& count() ) // corner intersections are ignored
     {
       c.type = ContType::JOINT;
-      c.p1 = center;
+      b.p1 = center;
       //vec2d r12 = vec3_to_vec2( e2_to_e1 * NORTH ); //calculated before
       vec2d r2 = center - r12;
 
-      c.p2 = vec3_to_vec2( dest_to_src * vec2_to_vec3( r2 ) );
+      b.p2 = vec3_to_vec2( dest_to_src * vec2_to_vec3( r2 ) );
       //c._F = { center, vec3_to_vec2( dest_to_src * vec2_to_vec3( r2 ) ) };
 //      print(center);
 //      print(r12);
-//      print(c.p1);
-//      print(c.p2);
+//      print(b.p1);
+//      print(b.p2);
 //      cout<<"===\n";
-      c.durability = 1.;
-      if( dump.size() > 2 ) c.init_size = size;  // only if size is area
+      b.durability = 1.;
+      if( dump.size() > 2 ) b.init_size = size;  // only if size is area
 
       //search for length of original mutual edge
-      c.init_len = c.find_edges( siku );
+      b.init_len = c.find_edges( siku, b );
 
       // if no edges such edges detected: L = S / Re, Re - radius of equivalent
       // circle of geometric mean of areas
-      if( !c.init_len && dump.size() > 2 )
-        c.init_len = size * sqrt( M_PI / sqrt( e1.A * e2.A ) );
+      if( !b.init_len && dump.size() > 2 )
+        b.init_len = size * sqrt( M_PI / sqrt( e1.A * e2.A ) );
     }
 }
 
 // --------------------------------------------------------------------------
 
-void _share( ContactDetector::Contact& c, Globals& siku, double tol )
+void _share( ContactDetector::Contact& c, ContactDetector::Bond& b,
+             Globals& siku, double tol )
 {
   Element& e1 = siku.es[c.i1];
   Element& e2 = siku.es[c.i2];
@@ -560,14 +1157,14 @@ void _share( ContactDetector::Contact& c, Globals& siku, double tol )
           if( abs2(e1.P[ ip1 ] - e2.P[ jm1 ]) < tolerance )
             {
               //cout<<"joint"<<endl;
-              c.v11 = i;
-              c.v12 = ip1;
-              c.v21 = jm1;
-              c.v22 = j;
+              b.v11 = i;
+              b.v12 = ip1;
+              b.v21 = jm1;
+              b.v22 = j;
 
               c.type = JOINT;
               c.step = siku.time.get_n();
-              c.durability = 1.;
+              b.durability = 1.;
 
               return;
             }
@@ -577,7 +1174,8 @@ void _share( ContactDetector::Contact& c, Globals& siku, double tol )
 
 // --------------------------------------------------------------------------
 
-void _dist_freeze( ContactDetector::Contact& c, Globals& siku, double tol )
+void _dist_freeze( ContactDetector::Contact& c, ContactDetector::Bond& b,
+                   Globals& siku, double tol )
 {
   Element &e1 = siku.es[c.i1], &e2 = siku.es[c.i2];
 
@@ -588,20 +1186,20 @@ void _dist_freeze( ContactDetector::Contact& c, Globals& siku, double tol )
   std::vector<vec2d> dump;
   std::vector<PointStatus> ps;
 
-  mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-  mat3d e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+  mat3d e1_to_e2 = glm::transpose( e2_to_e1 );
 
   //OR vec2d r2 = - vec3_to_vec2( e1_to_e2 * NORTH );
   vec2d r12 = vec3_to_vec2( e2_to_e1 * NORTH );
 
   // just-for-sure check
-  if( c.find_edges( siku ) )
+  if( c.find_edges( siku, b ) )
     {
       // important vertices in 2d relied to e1
-      vec2d t11 = vec3_to_vec2( e1.P[c.v11] ),
-            t12 = vec3_to_vec2( e1.P[c.v12] ),
-            t21 = vec3_to_vec2( e2_to_e1 * e2.P[c.v21] ),
-            t22 = vec3_to_vec2( e2_to_e1 * e2.P[c.v22] );
+      vec2d t11 = vec3_to_vec2( e1.P[b.v11] ),
+            t12 = vec3_to_vec2( e1.P[b.v12] ),
+            t21 = vec3_to_vec2( e2_to_e1 * e2.P[b.v21] ),
+            t22 = vec3_to_vec2( e2_to_e1 * e2.P[b.v22] );
 
       // if edges are close enough
       if( segment2d_distance( t11, t12, t21, t22 ) < abs( r12 ) * tol )
@@ -612,21 +1210,21 @@ void _dist_freeze( ContactDetector::Contact& c, Globals& siku, double tol )
           vec2d c2 = ( t12 + t21 ) * 0.5;
 
           // points of contact in two coord systems
-          c.p1 = c1;
-          c.p2 = c2;
+          b.p1 = c1;
+          b.p2 = c2;
           vec3d tv1 = { c1.x, c1.y, sqrt( 1. - c1.x*c1.x - c1.y*c1.y ) };
           vec3d tv2 = { c2.x, c2.y, sqrt( 1. - c2.x*c2.x - c2.y*c2.y ) };
-          c.p3 = vec3_to_vec2( e1_to_e2 * tv2 );
-          c.p4 = vec3_to_vec2( e1_to_e2 * tv1 );
+          b.p3 = vec3_to_vec2( e1_to_e2 * tv2 );
+          b.p4 = vec3_to_vec2( e1_to_e2 * tv1 );
 
-          c.init_len = abs( c1 - c2 );  // initial len is distance between
+          b.init_len = abs( c1 - c2 );  // initial len is distance between
                                         // 'springs'
-          //old //c.init_size = abs( r12 );
+          //old //b.init_size = abs( r12 );
           // initial size is a sum of distances between centers of elements
           // and contact zone (0.5 factored out of vectors averaging)
-          c.init_size = ( abs(c.p1 + c.p2) + abs(c.p3 + c.p4) )*0.5;
+          b.init_size = ( abs(b.p1 + b.p2) + abs(b.p3 + b.p4) )*0.5;
 
-          c.durability = 1.;
+          b.durability = 1.;
         }
     }
   else
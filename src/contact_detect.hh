@@ -27,8 +27,10 @@
 #include "siku.hh"
 #include "element.hh"
 #include "coordinates.hh"
+#include "bvtree.hh"
 
 #include <vector>
+#include <cstdint>
 
 // predeclaration due to circled includes (yes, we have spaghetti-code)
 struct Globals;
@@ -37,16 +39,27 @@ struct Globals;
 enum : unsigned long
 {
   CONTACTS_N2 = 0,
-  SWEEP_N_PRUNE = 1
+  SWEEP_N_PRUNE = 1,
+  CELL_LIST = 2,
+  BV_TREE = 3
 };
 
 // enum of methods for contact detection frequency calculation
 enum : unsigned long
 {
   ALWAYS = 0,
-  BY_TICKS = 2,
-  BY_SECONDS = 3,
-  BY_SPEED = 4
+  BY_TICKS = 1,
+  BY_SECONDS = 2,
+  BY_SPEED = 3,
+  BY_SKIN = 4   // Verlet lists: 'det_value' is a skin thickness
+};
+
+// mid phase cascade depth: tests applied to pairs after broad phase
+enum : unsigned long
+{
+  CASCADE_CAP = 0,    // bounding caps only
+  CASCADE_OBB = 1,    // + oriented bounding boxes
+  CASCADE_POLY = 2    // + exact separating axis test of polygons
 };
 
 // contact state flag (outside of classes for fast access)
@@ -103,20 +116,14 @@ class ContactDetector
 //  };
 
 public:
-  //! \brief Inner structure for holding interaction pairs metadata
-  struct Contact
+  //! \brief Bond-only state of contact (used by JOINT contacts only).
+  //! Stored in ContactStore in parallel with contacts.
+  struct Bond
   {
-    ContType type { NONE };
-    size_t i1 { 0 };
-    size_t i2 { 0 };
-
-    int step{ -1 };  // step when was created. -1 marks default object
-    double area{ 0. };  // area of contact
     double durability{ 1. };  // IMPROVE: must be discussed
     // TODO: discuss and change following names
     double init_size{ 0. };  // initial size. Must be discussed
     double init_len{ 0. }; // initial length. Must be discussed
-    int generation{ 0 };  // 'oldness'
 
     // In different physics approaches the points` meaning is different:
     // in _test_spring p1 and p2 are the positions of 'joint point' in
@@ -125,23 +132,36 @@ public:
     Geometry::vec2d p1{}, p2{},  // positions of joint centerS in local
                     p3{}, p4{};  // coords of contacting polygons
 
-
     size_t v11 {};  // indexes of vertices of shearing edge
     size_t v12 {};
     size_t v21 {};
     size_t v22 {};
+  };
+
+  //! \brief Inner structure for holding interaction pairs metadata. Only
+  //! fields used by all contacts (and detection) are kept here: bond-only
+  //! state of joints is stored separately in 'Bond' (see ContactStore)
+  struct Contact
+  {
+    size_t i1 { 0 };  // positions (not ids) of elements in 'siku.es'. Not
+    size_t i2 { 0 };  // ordered after elements reordering
+
+    double area{ 0. };  // area of contact
+    ContType type { NONE };
+
+    int step{ -1 };  // step when was created. -1 marks default object
+    int generation{ 0 };  // 'oldness'
+
+    // witness separating axis found at previous step: k < e1.P.size() -
+    // normal of e1 edge k, otherwise - normal of e2 edge (k - e1.P.size()).
+    // -1 if polygons were not separated
+    int sep { -1 };
 
     //! \brief Search for common (or hopefully the closest) edge of two
     // elements in contact.
-    //! \return: mean length of edges on success, 0 on failure
-    double find_edges( Globals& siku );
-
-//    union
-//    {
-//      _Frozen _F;
-//      _Shared _S;
-//      _Collision _C;
-//    };
+    //! \return: mean length of edges on success, 0 on failure. Edges`
+    //! vertices are stored in 'b'
+    double find_edges( Globals& siku, Bond& b ) const;
 
     // -------------------------------
 
@@ -168,6 +188,137 @@ public:
     }
   };
 
+  //! \brief Contacts storage: dense array of contacts indexed by hash table
+  //! with (i1, i2) keys. Provides O(1) search, insertion and deletion.
+  //! JOINT contacts are kept at the beginning of array and are never moved
+  //! by insertions or deletions of other contacts. Bonds are kept in
+  //! separate array with the same positions, so loops over contacts do not
+  //! load bond-only data.
+  class ContactStore
+  {
+  public:
+    typedef std::vector<Contact>::iterator iterator;
+    typedef std::vector<Contact>::const_iterator const_iterator;
+
+    // ------------------------------ access --------------------------------
+
+    inline size_t size() const { return items.size(); }
+    inline bool empty() const { return items.empty(); }
+
+    inline Contact& operator[] ( size_t k ) { return items[k]; }
+    inline const Contact& operator[] ( size_t k ) const { return items[k]; }
+
+    //! \brief bond of contact at position k
+    inline Bond& bond( size_t k ) { return bonds[k]; }
+    inline const Bond& bond( size_t k ) const { return bonds[k]; }
+
+    inline iterator begin() { return items.begin(); }
+    inline iterator end() { return items.end(); }
+    inline const_iterator begin() const { return items.begin(); }
+    inline const_iterator end() const { return items.end(); }
+
+    //! \brief raw contacts array (for saving)
+    inline const Contact* data() const { return items.data(); }
+
+    //! \brief amount of JOINT contacts (they are first in array)
+    inline size_t joints() const { return nj; }
+
+    //! \brief search for a contact between two elements (in any order)
+    //! \return pointer to contact or nullptr if there is no such contact
+    Contact* find( size_t i1, size_t i2 );
+
+    // ---------------------------- modification ----------------------------
+
+    //! \brief adds a contact if there is no contact with such indexes yet
+    //! \return true if the contact was added
+    bool insert( const Contact& c, const Bond& b );
+    inline bool insert( const Contact& c ) { return insert( c, Bond() ); }
+
+    //! \brief deletes contact by its position in array. The last contact
+    //! (of the same group - joint or not) takes its place.
+    void erase( size_t k );
+
+    //! \brief changes the type of contact at position k keeping joints at
+    //! the beginning of the array. Other contact may take position k.
+    void set_type( size_t k, ContType t );
+
+    //! \brief restores joints-first order and index after contacts` types
+    //! were changed directly
+    void repartition();
+
+    //! \brief deletes all contacts (memory is not released)
+    void clear();
+
+    //! \brief changes elements` indexes after reordering of elements.
+    //! new_slot[ old index ] = new index
+    void renumber( const std::vector<size_t>& new_slot );
+
+  private:
+    //! \brief hash table bucket: contact key and its position in array
+    struct Bucket
+    {
+      uint64_t key;
+      size_t pos;
+    };
+
+    static const uint64_t EMPTY { ~uint64_t( 0 ) };
+
+    std::vector<Contact> items;    // contacts (joints first)
+    std::vector<Bond> bonds;       // bonds of contacts (same positions)
+    size_t nj { 0 };               // amount of joints
+    std::vector<Bucket> table;     // open addressing, linear probing
+    size_t mask { 0 };             // table.size() - 1
+
+    // key of element pair (order independent)
+    static inline uint64_t _key( size_t i1, size_t i2 )
+    {
+      return i1 < i2 ? ( uint64_t( i1 ) << 32 ) | uint64_t( i2 )
+                     : ( uint64_t( i2 ) << 32 ) | uint64_t( i1 );
+    }
+    static inline uint64_t _key( const Contact& c )
+    {
+      return _key( c.i1, c.i2 );
+    }
+
+    size_t _probe( uint64_t key ) const;  // bucket of key or empty bucket
+    void _rehash( size_t capacity );
+    void _remove_key( uint64_t key );
+    void _move( size_t from, size_t to ); // moves contact inside array
+  };
+
+  //! \brief integer coordinates of a cell in uniform 3d grid (cell list)
+  struct GridCell
+  {
+    long x, y, z;
+
+    inline bool operator == ( const GridCell& c ) const
+    {
+      return x == c.x && y == c.y && z == c.z;
+    }
+  };
+
+  //! \brief endpoints of element projection on sweep axis (and some data
+  //! for pruning on second axis) for persistent sweep and prune
+  struct SapEntry
+  {
+    double lo, hi;    // interval on sweep axis
+    double c2;        // projection of center on second axis
+    double r;         // bounding radius
+    size_t i;         // index of element in Globals.es
+  };
+
+  //! \brief statistics of mid phase cascade: amount of pairs rejected at
+  //! each stage and amount of pairs passed all stages
+  struct CascadeStats
+  {
+    unsigned long cap { 0 };
+    unsigned long obb { 0 };
+    unsigned long poly { 0 };
+    unsigned long passed { 0 };
+
+    inline unsigned long tested() const { return cap + obb + poly + passed; }
+  };
+
   //! \brief Method specifier (ye, i know what 'meth' means...)
   unsigned long det_meth{ CONTACTS_N2 };
 
@@ -182,13 +333,59 @@ public:
 
   std::vector<Link> links;
 
+  //! \brief depth of mid phase tests cascade
+  unsigned long det_cascade{ CASCADE_CAP };
+
+  //! \brief cascade statistics of the last detection (zero if there was no
+  //! detection at current step)
+  CascadeStats cstats;
+
 private:
   //! \brief util value to store previous 'det_value'
   double det_last{ 0. };
+
+  //! \brief additional distance (on unit sphere) between bounding spheres
+  //! for pairs to be listed. Nonzero only for Verlet lists ('BY_SKIN')
+  double det_margin{ 0. };
+
+  //! \brief elements` positions at last detection (for Verlet lists)
+  std::vector<vec3d> det_pos;
+
+  //! \brief sweep and prune entries. Remain sorted by 'lo' between calls,
+  //! so re-sorting of nearly ordered array is cheap.
+  std::vector<SapEntry> sap;
+
+  //! \brief sweep (principal direction of pack) and prune axes
+  vec3d sap_ax1{}, sap_ax2{};
+
+  //! \brief bounding volume trees of moving and static (borders,
+  //! landfast) elements. Static tree is built once.
+  BVTree bvt_dyn, bvt_stat;
+
+  //! \brief amount of elements when the trees were built
+  size_t bvt_size{ 0 };
+
+  //! \brief candidate pairs found by trees (kept between calls)
+  BVTree::Pairs bvt_pairs;
+
+  //! \brief cell list buffers (kept between calls): cell of each element,
+  //! first element in hash bucket and next element in the same bucket
+  std::vector<GridCell> cl_cells;
+  std::vector<long> cl_head;
+  std::vector<long> cl_next;
+
+  //! \brief new contacts found by each block of detection loop. Blocks are
+  //! processed by different threads and merged in blocks` order, so the
+  //! result does not depend on the amount of threads.
+  std::vector<std::vector<Contact>> news;
+
+  //! \brief cascade statistics of each block (merged with 'news')
+  std::vector<CascadeStats> news_st;
+
 public:
 
   // contacts pool
-  std::vector < Contact > cont;
+  ContactStore cont;
 
   //------------------------------- methods ----------------------------------
 
@@ -204,18 +401,50 @@ public:
   //! hit data in scenario script
   void freeze_links( Globals& siku );
 
+  //! \brief Method for updating contacts and detection caches after
+  //! reordering of elements array. new_slot[ old index ] = new index
+  void renumber( const std::vector<size_t>& new_slot );
+
 private:
   //! \brief method to check if it is time to update contacts
   bool is_detect_time( Globals& siku );
 
+  //! \brief prepares 'news' buffers for detection loop of 'n' iterations.
+  //! \return amount of blocks
+  size_t news_open( size_t n );
+
+  //! \brief moves new contacts from all blocks into 'cont'
+  void news_merge();
+
+  //! \brief mid phase: bounding caps, then oriented boxes, then polygons
+  //! (up to 'det_cascade' depth). All tests are inflated by 'det_margin'.
+  //! All stages bound the collision polygon 'Element::coll()' (the proxy if
+  //! it was built), as the narrow phase does.
+  //! \return true if the pair may be in contact
+  bool mid_phase( const Element& e1, const Element& e2,
+                  CascadeStats& st ) const;
+
   //! \brief simple method for contacts detection. N^2 complexity.
   void find_pairs( Globals& siku );
 
   //! \brief sweep and prune method for contacts detection.
   void sweep_n_prune( Globals& siku );
 
+  //! \brief uniform cell list method for contacts detection. Elements are
+  //! binned by their 'Glob' into a grid of cubic cells (sized by the largest
+  //! bounding radius) cutting the unit sphere. Pairs are searched only
+  //! within neighbouring cells, which gives O(N) complexity.
+  void cell_list( Globals& siku );
+
+  //! \brief bounding volume hierarchy method for contacts detection. Moving
+  //! elements are kept in a dynamic tree refitted incrementally, static
+  //! ones - in a separate tree that is built once. Pairs of two static
+  //! elements are not searched.
+  void bv_tree( Globals& siku );
+
   //! \brief smart cleaning of contacts list. 'Frozen' (coalesced) contacts
-  //! remain untouched until destroyed, other are renewed at each step
+  //! remain untouched until destroyed, other are aged and deleted after
+  //! several detections
   void clear();
 
 };
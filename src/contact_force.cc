@@ -21,6 +21,12 @@
  */
 
 #include <cmath>
+#include <atomic>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "contact_force.hh"
 
@@ -34,14 +40,154 @@ using namespace Geometry;
 
 // ======================== local utility struct ============================
 
+// Per-thread scratch buffers of narrow phase. Their capacity grows up to the
+// largest polygons met and is reused afterwards, so in steady state there are
+// no heap allocations per contact.
+struct NarrowScratch
+{
+  vector<vec2d> P2;             // e2.P vertices in e1 local 2d coords
+  vector<vec2d> inter;          // intersection polygon
+  vector<PointStatus> stats;    // statuses of points in 'inter'
+#ifdef SIKU_PRECISION_CHECK
+  vector<vec2d> check;          // double precision intersection polygon
+#endif
+
+  inline size_t capacity() const
+  {
+    return P2.capacity() + inter.capacity() + stats.capacity();
+  }
+};
+
+static thread_local NarrowScratch scratch;
+
+// amount of scratch buffers reallocations (should stop growing after first
+// steps)
+static std::atomic<unsigned long> scratch_grows { 0 };
+
+#ifdef SIKU_PRECISION_CHECK
+// narrow phase precision validation: amount of checked intersections, amount
+// of those with different result (overlap / no overlap) and maximal relative
+// difference of overlap area with full double precision clipping
+static std::atomic<unsigned long> prec_checked { 0 };
+static std::atomic<unsigned long> prec_mismatched { 0 };
+static std::atomic<double> prec_max_err { 0. };
+
+// repeats intersection of P1 and P2 in double and compares results
+inline void _precision_check( const vector<vec2d>& P1,
+                              const vector<vec2d>& P2, int res, double area )
+{
+  double a = 0.;
+  int r = intersect_rourke_t<double>( P1.data(), P1.size(),
+                                      P2.data(), P2.size(),
+                                      scratch.check, nullptr, nullptr, &a );
+  ++prec_checked;
+
+  if( ( r > 2 ) != ( res > 2 ) )
+    {
+      ++prec_mismatched;
+      return;
+    }
+
+  if( r > 2 && a > 0. )
+    {
+      double err = abs( area - a ) / a;
+      double cur = prec_max_err;
+      while( err > cur && !prec_max_err.compare_exchange_weak( cur, err ) );
+    }
+}
+#endif
+
+// counts reallocation of scratch if its capacity has changed
+inline void _scratch_check( size_t cap_before )
+{
+  if( scratch.capacity() != cap_before )
+    ++scratch_grows;
+}
+
+// collision polygon of e2 in local coords of e1 into scratch (e1 polygon is
+// cached in e1.coll())
+inline void _local_poly( const Element& e2, const mat3d& e2_to_e1 )
+{
+  scratch.P2.clear();
+  if( e2.C2.empty() )
+    for( auto& p : e2.P )
+      scratch.P2.push_back( vec3_TO_vec2( e2_to_e1 * p ) );
+  else  // simplified proxy
+    for( auto& p : e2.C2 )
+      scratch.P2.push_back( vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( p ) ) );
+}
+
+#ifdef SIKU_CONTACT_STATS
+// separating axis test statistics: witness axis from previous step still
+// separates / other axis found / polygons overlap (full intersection).
+// Shared counters are touched by every contact: developer builds only
+static std::atomic<unsigned long> sat_hits { 0 };
+static std::atomic<unsigned long> sat_misses { 0 };
+static std::atomic<unsigned long> sat_overlaps { 0 };
+#define SAT_COUNT( c ) c.fetch_add( 1, std::memory_order_relaxed )
+#else
+#define SAT_COUNT( c )
+#endif
+
+// checks if edge k of polygon P (with outward normal n) separates P from Q
+inline bool _separates( const vec2d& p, const vec2d& n,
+                        const vector<vec2d>& Q )
+{
+  for( auto& q : Q )
+    if( dot( n, q - p ) <= 0. ) return false;
+  return true;
+}
+
+// checks axis 'k' of combined edges list of e1 (cached normals) and e2 (in
+// scratch, e1 local coords)
+inline bool _sat_axis( const Element& e1, const vector<vec2d>& P2, int k )
+{
+  const vector<vec2d>& P1 = e1.coll();
+  size_t n1 = P1.size();
+  if( size_t( k ) < n1 )
+    return _separates( P1[k], e1.coll_n()[k], P2 );
+
+  size_t j = k - n1, jn = ( j + 1 ) % P2.size();
+  return _separates( P2[j], rot_90_cw( P2[jn] - P2[j] ), P1 );
+}
+
+// exact separating axis test of convex polygons e1 and e2 (scratch.P2).
+// The witness axis of previous step is checked first, so for stable
+// separated pairs the test costs a single edge projection.
+inline bool _separated( const Element& e1, ContactDetector::Contact& c )
+{
+  const vector<vec2d>& P2 = scratch.P2;
+  int n = int( e1.coll().size() + P2.size() );
+
+  if( c.sep >= 0 && c.sep < n && _sat_axis( e1, P2, c.sep ) )
+    {
+      SAT_COUNT( sat_hits );
+      return true;
+    }
+
+  for( int k = 0; k < n; ++k )
+    if( k != c.sep && _sat_axis( e1, P2, k ) )
+      {
+        c.sep = k;
+        SAT_COUNT( sat_misses );
+        return true;
+      }
+
+  c.sep = -1;
+  SAT_COUNT( sat_overlaps );
+  return false;
+}
+
 // local structure for intersection (overlapping) data.
 // !members` declaration order supposed to be optimized by memory
 struct CollisionData
 {
-  vector<vec2d> loc_P1;         // e1.P vertices in local 2d coor
-  vector<vec2d> loc_P2;         // e2.P vertices in local 2d coords
-  vector<vec2d> interPoly;      // intersection polygon
-  vector<PointStatus> stats;    // statuses of points in interPoly
+  const vector<vec2d>& loc_P1;  // e1 collision polygon in local 2d coords
+                                // (cached)
+  vector<vec2d>& loc_P2;        // e2 collision polygon in e1 local coords
+  vector<vec2d>& interPoly;     // intersection polygon
+  vector<PointStatus>& stats;   // statuses of points in interPoly
+                                // (last three are thread scratch buffers)
 
   mat3d e1_to_e2;               // matrix for coordinates transformation
   mat3d e2_to_e1;               // between e1 and e2 local systems
@@ -56,42 +202,60 @@ struct CollisionData
 
   ContactDetector::Contact& c;  // some references
   Globals& siku;
-  Element& e1, e2;
+  Element& e1, & e2;
 
   int inter_res;                // amount of intersection points (just in case)
 
   // ALL values are being calculated in constructor
   CollisionData( ContactDetector::Contact& _c, Globals& _siku ):
+    loc_P1( _siku.es[ _c.i1 ].coll() ), loc_P2( scratch.P2 ),
+    interPoly( scratch.inter ), stats( scratch.stats ),
     siku( _siku ), c( _c ), e1( siku.es[ c.i1 ] ), e2( siku.es[ c.i2 ] )
   {
-    VERIFY( e1.q, "CollDat");
-    VERIFY( e2.q, "CollDat");
+    VERIFY( siku.es.q[ c.i1 ], "CollDat");
+    VERIFY( siku.es.q[ c.i2 ], "CollDat");
+
+    size_t cap = scratch.capacity();
 
     // coordinates transformation matrixes (local systems of two elements)
-    e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-    e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+    e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+    e1_to_e2 = glm::transpose( e2_to_e1 );
 
     // polygons in local (e1) coords
-    for( auto& p : e1.P ) loc_P1.push_back( vec3_TO_vec2( p ) );
-    for( auto& p : e2.P ) loc_P2.push_back( vec3_TO_vec2( e2_to_e1 * p ) );
+    _local_poly( e2, e2_to_e1 );
 
     // errors check
 //    if( errored( loc_P1 ) )   e1.flag |= Element::F_ERRORED;
 //    if( errored( loc_P2 ) )   e2.flag |= Element::F_ERRORED;
 
+    // most of pairs from broad phase do not overlap: no need in anything else
+    if( _separated( e1, c ) )
+      {
+        _scratch_check( cap );
+        inter_res = 0;
+        area = 0.;
+        return;
+      }
+
     // call for 'geometry'->'2d'->'polygon intersection'
-    inter_res = intersect( loc_P1, loc_P2, interPoly, &stats, &r1, &area );
+    inter_res = intersect_rourke( loc_P1.data(), loc_P1.size(),
+                                  loc_P2.data(), loc_P2.size(),
+                                  interPoly, &stats, &r1, &area );
+#ifdef SIKU_PRECISION_CHECK
+    _precision_check( loc_P1, loc_P2, inter_res, area );
+#endif
+    _scratch_check( cap );
     // and calc centers` interpositions
     r12 = vec3_TO_vec2( e2_to_e1 * NORTH );
     r2 = r1 - r12;
 
     // IMPROVE: check order of planet.R carefully!
     // e1 aim speed (coz of spin + propagation)
-    va1 = vec3_to_vec2( e1.V )
-        + rot_90_cw( r1 ) * ( -e1.W.z * siku.planet.R );
+    va1 = vec3_to_vec2( siku.es.V[ c.i1 ] )
+        + rot_90_cw( r1 ) * ( -siku.es.W[ c.i1 ].z * siku.planet.R );
     // e2 aim speed (spin + propagation)
-    va2 = vec3_to_vec2( lay_on_surf( e2_to_e1 * e2.V ) )
-        + rot_90_cw( r2 ) * ( -e2.W.z * siku.planet.R );
+    va2 = vec3_to_vec2( lay_on_surf( e2_to_e1 * siku.es.V[ c.i2 ] ) )
+        + rot_90_cw( r2 ) * ( -siku.es.W[ c.i2 ].z * siku.planet.R );
 
     // velocity difference at aim point
     va12 = va1 - va2;
@@ -99,19 +263,41 @@ struct CollisionData
 
 };
 
+// Reaction of one contact: forces and torques applied to its elements and
+// fastening data. Kernels write reactions instead of elements, so contacts
+// can be processed in parallel. Reactions are applied to elements after.
+struct Reaction
+{
+  vec3d F1 {}, F2 {};           // forces applied to c.i1 and c.i2
+  double N1 { 0. }, N2 { 0. };  // torques applied to c.i1 and c.i2
+  double oa { 0. };             // overlap area added to both elements
+  double oam { 0. };            // minimal area for fastening check (0 - no)
+};
+
 // ==================== local functions` declarations =======================
 
-void _test_springs( ContactDetector::Contact& c, Globals& siku );
+// collision forces (same for all force models)
+void _collision( Globals& siku, ContactDetector::Contact& c, Reaction& r );
+
+// joint forces of each force model
+void _test_springs( ContactDetector::Contact& c,
+                    ContactDetector::Bond& b, Globals& siku,
+                    Reaction& r );
 
-void _hopkins_frankenstein( ContactDetector::Contact& c, Globals& siku );
+void _hopkins_frankenstein( ContactDetector::Contact& c,
+                            ContactDetector::Bond& b, Globals& siku,
+                            Reaction& r );
 
-void _distributed_springs( ContactDetector::Contact& c, Globals& siku );
+void _distributed_springs( ContactDetector::Contact& c,
+                           ContactDetector::Bond& b, Globals& siku,
+                           Reaction& r );
 
 void _err_n_land_test( Element &e1, Element &e2,
-                       mat3d& e2_to_e1, mat3d& e1_to_e2 );
+                       mat3d& e2_to_e1, mat3d& e1_to_e2, Reaction& r );
 
 void _fasten( Element &e1, Element &e2, double area,
-                const vector<vec2d>& l1, const vector<vec2d>& l2 );
+                const vector<vec2d>& l1, const vector<vec2d>& l2,
+                Reaction& r );
 
 // -----------------------------------------------------------------------
 
@@ -119,7 +305,7 @@ void _fasten( Element &e1, Element &e2, double area,
 inline double _rigidity( CollisionData& cd )
 {
  // BUG: factors at elastic collision and dist spring should be the same!
-  return cd.siku.phys_consts["elasticity"] * cd.siku.planet.R_rec
+  return cd.siku.pc.elasticity * cd.siku.planet.R_rec
       / ( abs(cd.r1) + (cd.r2) );
 
 
@@ -137,7 +323,7 @@ inline double _rigidity( CollisionData& cd )
   // result reduced rigidity (improve: comments 'приведенная жесткость'):
   // close-to-linear-spring rigidity of ice
   return h1*h2 / ( h1*abs( cd.r2 ) + h2*abs( cd.r1 ) )
-               * cd.siku.phys_consts["sigma"] * cd.siku.planet.R_rec;
+               * cd.siku.pc.sigma * cd.siku.planet.R_rec;
 }
 
 // viscous and elastic forces applied to e1 caused by e2.
@@ -182,37 +368,340 @@ inline vec2d _elastic_force( CollisionData& cd )
 }
 inline vec2d _viscous_force( CollisionData& cd )
 {
-  return -cd.area * cd.siku.planet.R2 * cd.siku.phys_consts["etha"] * cd.va12;
+  return -cd.area * cd.siku.planet.R2 * cd.siku.pc.etha * cd.va12;
+}
+
+// reactions of one element accumulated from its contacts
+struct Accum
+{
+  vec3d F {};
+  double N { 0. };
+  double oa { 0. };
+  double oam { 0. };            // 0 - no fastening checks
+};
+
+inline void _add( Accum& a, const vec3d& F, double N, const Reaction& r )
+{
+  a.F += F;
+  a.N += N;
+  a.oa += r.oa;
+  if( r.oam > 0. && ( a.oam == 0. || r.oam < a.oam ) )
+    a.oam = r.oam;
+}
+
+inline void _apply( ElementStore& es, size_t i, const Accum& a )
+{
+  Element& e = es[i];
+  es.F[i] += a.F;
+  es.N[i] += a.N;
+  e.OA += a.oa;
+  if( a.oam > 0. )
+    e.OAM = min( e.OAM, a.oam );
+}
+
+inline int _threads_amount()
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+inline int _team_size()
+{
+#ifdef _OPENMP
+  return omp_get_num_threads();
+#else
+  return 1;
+#endif
+}
+
+inline int _thread_num()
+{
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+// No need to calculate interaction for two steady or two sleeping polygons
+// and for sleeping polygon touching static one. Steady polygon may move and
+// push a sleeping one (it is woken up by sleeping_wake then).
+// TODO: reconsider runtime fastened ice
+inline bool _idle( const ContactDetector::Contact& c, const Globals& siku )
+{
+  const unsigned int f1 = siku.es[c.i1].flag, f2 = siku.es[c.i2].flag;
+
+  return ( ( f1 & Element::F_STEADY ) && ( f2 & Element::F_STEADY ) )
+      || ( ( f1 & Element::F_SLEEPING ) && ( f2 & Element::F_SLEEPING ) )
+      || ( ( f1 & Element::F_SLEEPING ) && ( f2 & Element::F_STATIC ) )
+      || ( ( f2 & Element::F_SLEEPING ) && ( f1 & Element::F_STATIC ) );
 }
 
+// Joint kernel of force model, chosen at compile time. Joints and other
+// contacts are kept in separate ranges of the store (joints first), so each
+// range is processed by its own loop without type checks.
+template< CONTACT_FORCE_MODEL M > struct Joint;
+
+template<> struct Joint< CF_TEST_SPRINGS >
+{
+  static inline void force( ContactDetector::Contact& c,
+                            ContactDetector::Bond& b, Globals& siku,
+                            Reaction& r )
+  { _test_springs( c, b, siku, r ); }
+};
+
+template<> struct Joint< CF_HOPKINS >
+{
+  static inline void force( ContactDetector::Contact& c,
+                            ContactDetector::Bond& b, Globals& siku,
+                            Reaction& r )
+  { _hopkins_frankenstein( c, b, siku, r ); }
+};
+
+template<> struct Joint< CF_DIST_SPRINGS >
+{
+  static inline void force( ContactDetector::Contact& c,
+                            ContactDetector::Bond& b, Globals& siku,
+                            Reaction& r )
+  { _distributed_springs( c, b, siku, r ); }
+};
+
+// contacts per thread in one chunk of dynamic scheduling
+static const int CF_CHUNK = 64;
+
 // =========================== contact force ================================
 
+// Per-thread accumulators: each thread sums reactions of its contacts into
+// own copy of elements` accumulators and lists elements it touched. Then each
+// thread reduces copies for its own range of elements in threads` order.
+// Contacts are split between threads statically, so results do not change
+// from run to run with the same amount of threads (but depend on it). Only
+// touched entries are read and cleaned: the cost follows contacts amount.
+struct ThreadAccum
+{
+  vector<Accum> acc;            // by element position, zero if not touched
+  vector<unsigned char> used;   // element was touched in current step
+  vector<size_t> touched;       // touched elements (sorted before reduction)
+};
+
+inline void _touch( ThreadAccum& ta, size_t i, const vec3d& F, double N,
+                    const Reaction& r )
+{
+  if( !ta.used[i] )
+    {
+      ta.used[i] = 1;
+      ta.touched.push_back( i );
+    }
+  _add( ta.acc[i], F, N, r );
+}
+
+template< CONTACT_FORCE_MODEL M >
+static void _contact_forces_threads( Globals& siku )
+{
+  static vector<ThreadAccum> accs;
+
+  auto& cont = siku.ConDet.cont;
+  const long nc = cont.size();
+  const long nj = cont.joints();
+  const size_t ne = siku.es.size();
+  int nt = _threads_amount();  // actual team may be smaller
+
+  if( accs.size() < size_t( nt ) ) accs.resize( nt );
+
+#pragma omp parallel
+  {
+#pragma omp single
+    nt = _team_size();
+
+    auto& ta = accs[ _thread_num() ];
+    if( ta.acc.size() != ne )   // elements amount changed (rare)
+      {
+        ta.acc.assign( ne, Accum() );
+        ta.used.assign( ne, 0 );
+      }
+    ta.touched.clear();
+
+    // joints
+#pragma omp for schedule(static) nowait
+    for( long k = 0; k < nj; ++k )
+      {
+        auto& c = cont[k];
+        if( _idle( c, siku ) ) continue;
+
+        Reaction r;
+        Joint< M >::force( c, cont.bond(k), siku, r );
+        _touch( ta, c.i1, r.F1, r.N1, r );
+        _touch( ta, c.i2, r.F2, r.N2, r );
+      }
+
+    // collisions
+#pragma omp for schedule(static) nowait
+    for( long k = nj; k < nc; ++k )
+      {
+        auto& c = cont[k];
+        if( _idle( c, siku ) ) continue;
+
+        Reaction r;
+        _collision( siku, c, r );
+        _touch( ta, c.i1, r.F1, r.N1, r );
+        _touch( ta, c.i2, r.F2, r.N2, r );
+      }
+
+    std::sort( ta.touched.begin(), ta.touched.end() );
+
+#pragma omp barrier
+
+    // reduction of own range of elements [lo, hi)
+    const size_t me = _thread_num();
+    const size_t lo = ne * me / nt, hi = ne * ( me + 1 ) / nt;
+
+    for( int t = 0; t < nt; ++t )
+      {
+        auto& o = accs[t];
+        auto it = std::lower_bound( o.touched.begin(), o.touched.end(), lo );
+        for( ; it != o.touched.end() && *it < hi; ++it )
+          {
+            _apply( siku.es, *it, o.acc[ *it ] );
+            o.acc[ *it ] = Accum();
+            o.used[ *it ] = 0;
+          }
+      }
+  }
+}
+
+// Deterministic summation: reactions are stored per contact, then each
+// element gathers reactions of its contacts in contacts` order (by compressed
+// element-to-contacts index). Results do not depend on the amount of threads.
+template< CONTACT_FORCE_MODEL M >
+static void _contact_forces_ordered( Globals& siku )
+{
+  static vector<Reaction> reacts;
+  static vector<size_t> beg, fill, idx;  // CSR: contacts of element i are
+                                         // idx[ beg[i] .. beg[i+1] )
+
+  auto& cont = siku.ConDet.cont;
+  const long nc = cont.size();
+  const long nj = cont.joints();
+  const size_t ne = siku.es.size();
+
+  reacts.assign( nc, Reaction() );
+
+#pragma omp parallel
+  {
+#pragma omp for schedule(dynamic, CF_CHUNK) nowait
+    for( long k = 0; k < nj; ++k )
+      if( !_idle( cont[k], siku ) )
+        Joint< M >::force( cont[k], cont.bond(k), siku, reacts[k] );
+
+#pragma omp for schedule(dynamic, CF_CHUNK)
+    for( long k = nj; k < nc; ++k )
+      if( !_idle( cont[k], siku ) )
+        _collision( siku, cont[k], reacts[k] );
+  }
+
+  // index: 2k - contact k as first element, 2k+1 - as second
+  beg.assign( ne + 1, 0 );
+  for( auto& c : cont )
+    {
+      ++beg[ c.i1 + 1 ];
+      ++beg[ c.i2 + 1 ];
+    }
+  for( size_t i = 0; i < ne; ++i )
+    beg[ i + 1 ] += beg[i];
+
+  fill.assign( beg.begin(), beg.end() - 1 );
+  idx.resize( 2 * nc );
+  for( long k = 0; k < nc; ++k )
+    {
+      idx[ fill[ cont[k].i1 ]++ ] = 2 * k;
+      idx[ fill[ cont[k].i2 ]++ ] = 2 * k + 1;
+    }
+
+#pragma omp parallel for schedule(static)
+  for( size_t i = 0; i < ne; ++i )
+    {
+      Accum a;
+      for( size_t j = beg[i]; j < beg[ i + 1 ]; ++j )
+        {
+          const Reaction& r = reacts[ idx[j] >> 1 ];
+          if( idx[j] & 1 )
+            _add( a, r.F2, r.N2, r );
+          else
+            _add( a, r.F1, r.N1, r );
+        }
+      _apply( siku.es, i, a );
+    }
+}
+
+template< CONTACT_FORCE_MODEL M >
+static void _contact_forces( Globals& siku )
+{
+  if( siku.cont_det_sum )
+    _contact_forces_ordered< M >( siku );
+  else
+    _contact_forces_threads< M >( siku );
+}
+
 void contact_forces( Globals& siku )
 {
+  if( siku.ConDet.cont.empty() ) return;
 
   switch( siku.cont_force_model )
   {
     case CF_TEST_SPRINGS: //same as CF_DEFAULT
-      for ( auto& c : siku.ConDet.cont )
-        _test_springs( c, siku );
+      _contact_forces< CF_TEST_SPRINGS >( siku );
       break;
 
     case CF_HOPKINS:
-      for ( auto& c : siku.ConDet.cont )
-        _hopkins_frankenstein( c, siku );
+      _contact_forces< CF_HOPKINS >( siku );
       break;
 
     case CF_DIST_SPRINGS:
-      for ( auto& c : siku.ConDet.cont )
-        _distributed_springs( c, siku );
+      _contact_forces< CF_DIST_SPRINGS >( siku );
       break;
-
   }
 }
 
 // ============================== definitions ==============================
 
-void _collision( Globals& siku, ContactDetector::Contact& c )
+unsigned long contact_scratch_grows()
+{
+  return scratch_grows;
+}
+
+void contact_precision_stats( unsigned long& checked,
+                              unsigned long& mismatched, double& max_err )
+{
+#ifdef SIKU_PRECISION_CHECK
+  checked = prec_checked;
+  mismatched = prec_mismatched;
+  max_err = prec_max_err;
+#else
+  checked = mismatched = 0;
+  max_err = 0.;
+#endif
+}
+
+// --------------------------------------------------------------------------
+
+void contact_sat_stats( unsigned long& hits, unsigned long& misses,
+                        unsigned long& overlaps )
+{
+#ifdef SIKU_CONTACT_STATS
+  hits = sat_hits;
+  misses = sat_misses;
+  overlaps = sat_overlaps;
+#else
+  hits = misses = overlaps = 0;
+#endif
+}
+
+// --------------------------------------------------------------------------
+
+void _collision( Globals& siku, ContactDetector::Contact& c, Reaction& r )
 {
   CollisionData cd( c, siku );
 
@@ -250,9 +739,9 @@ void _collision( Globals& siku, ContactDetector::Contact& c )
 //      vec2d center = ( p1p2[0] + p1p2[1] ) / 2.;
 //
 //      // physical constants (from python scenario)
-//      double Kne = siku.phys_consts["rigidity"],
-//             Kni = siku.phys_consts["viscosity"],
-//             Kw = siku.phys_consts["rotatability"],
+//      double Kne = siku.pc.rigidity,
+//             Kni = siku.pc.viscosity,
+//             Kw = siku.pc.rotatability,
 //             Kt = siku.phys_consts["tangency"];
 //
 //      double Asqrt = sqrt( area );
@@ -276,16 +765,16 @@ void _collision( Globals& siku, ContactDetector::Contact& c )
 //          vec3_to_vec2( e2_to_e1 * NORTH ), F );
 
       // force in Newtons applied to e1 caused by e2
-      vec2d F = _elastic_force( cd ) * siku.phys_consts["rigidity"]
-              + _viscous_force( cd ) * siku.phys_consts["viscosity"];
+      vec2d F = _elastic_force( cd ) * siku.pc.rigidity
+              + _viscous_force( cd ) * siku.pc.viscosity;
       VERIFY(_elastic_force( cd ), "" );
       VERIFY(_viscous_force( cd ), "" );
 
       double torque1 = cross( cd.r1, F )
-          * siku.planet.R_rec * siku.phys_consts["rotatability"];
+          * siku.planet.R_rec * siku.pc.rotatability;
 
       double torque2 = cross( cd.r2, F)
-          * siku.planet.R_rec * siku.phys_consts["rotatability"];
+          * siku.planet.R_rec * siku.pc.rotatability;
 
       VERIFY( F, string("in collision ")
               +to_string(siku.es[c.i1].id)
@@ -296,272 +785,231 @@ void _collision( Globals& siku, ContactDetector::Contact& c )
 
       // applying forces and torques
       // (signs are fitted manually)
-      siku.es[c.i1].F += vec2_to_vec3( F );
-      siku.es[c.i1].N += torque1;
+      r.F1 += vec2_to_vec3( F );
+      r.N1 += torque1;
 
-      siku.es[c.i2].F -= lay_on_surf( cd.e1_to_e2 * vec2_to_vec3( F ) );
-      siku.es[c.i2].N -= torque2;
+      r.F2 -= lay_on_surf( cd.e1_to_e2 * vec2_to_vec3( F ) );
+      r.N2 -= torque2;
 
       c.area = cd.area;
       VERIFY( c.area, "collision" );
-      VERIFY( siku.es[c.i1].F, "1collision");
-      VERIFY( siku.es[c.i2].F, "1collision");
+      VERIFY( r.F1, "1collision");
+      VERIFY( r.F2, "1collision");
 
-      _fasten( cd.e1, cd.e2, cd.area, cd.loc_P1, cd.loc_P2 );
+      _fasten( cd.e1, cd.e2, cd.area, cd.loc_P1, cd.loc_P2, r );
     }
 }
 
 // -----------------------------------------------------------------------
 
-void _test_springs( ContactDetector::Contact& c, Globals& siku )
+void _test_springs( ContactDetector::Contact& c,
+                    ContactDetector::Bond& b, Globals& siku,
+                    Reaction& r )
 {
-  // TODO: such errors should be removed by removing their reason
-  if(
-//      (siku.es[c.i1].flag & Element::F_ERRORED) ||
-//      (siku.es[c.i2].flag & Element::F_ERRORED) ||
-  // No need to calculate interaction for two steady polygons
-  // TODO: reconsider runtime fastened ice
-      ( (siku.es[c.i1].flag & Element::F_STEADY) &&
-          (siku.es[c.i2].flag & Element::F_STEADY) ) )
-    return;
+  Element& e1 = siku.es[c.i1], & e2 = siku.es[c.i2];
 
-  if( c.type != ContType::JOINT )
-    {
-      _collision( siku, c ); // collision forces
-    }
-  else  // <=> if( c.type == ContType::JOINT )
-    {
-      Element& e1 = siku.es[c.i1], e2 = siku.es[c.i2];
+  // coordinates transformation matrixes (local systems of two elements)
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+  mat3d e1_to_e2 = glm::transpose( e2_to_e1 );
 
-      // coordinates transformation matrixes (local systems of two elements)
-      mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-      mat3d e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+  // test for polygons convexity
+  _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2, r );
 
-      // test for polygons convexity
-      _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2 );
+  // -------------------------------------------------------------------
 
-      // -------------------------------------------------------------------
+  // physical constants (from python scenario)
+  double K = siku.pc.elasticity,
+         Kw = siku.pc.bendability,
+         sigma = siku.pc.solidity,
+         epsilon = siku.pc.tensility;
 
-      // physical constants (from python scenario)
-      double K = siku.phys_consts["elasticity"],
-             Kw = siku.phys_consts["bendability"],
-             sigma = siku.phys_consts["solidity"],
-             epsilon = siku.phys_consts["tensility"];
+  // calculating forces and torques
+  vec2d p1 = b.p1;
+  vec2d p2 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( b.p2 ) );
 
-      // calculating forces and torques
-      vec2d p1 = c.p1;
-      vec2d p2 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( c.p2 ) );
+  vec2d F = ( p2 - p1 ) * siku.planet.R * K * b.durability *
+      b.init_len;
+  // * b.init_size OR b.init_len;
 
-      vec2d F = ( p2 - p1 ) * siku.planet.R * K * c.durability *
-          c.init_len;
-      // * c.init_size OR c.init_len;
+  double torque1 =
+      Kw * siku.planet.R_rec * cross( p1, F );
 
-      double torque1 =
-          Kw * siku.planet.R_rec * cross( p1, F );
+  double torque2 =
+      Kw * siku.planet.R_rec * cross( p2 -
+         vec3_to_vec2( e2_to_e1 * NORTH) , F );
 
-      double torque2 =
-          Kw * siku.planet.R_rec * cross( p2 -
-             vec3_to_vec2( e2_to_e1 * NORTH) , F );
+  // applying forces and torques
+  // signs are fitted manually
+  r.F1 -= vec2_to_vec3( F );
+  r.N1 -= torque1;
 
-      // applying forces and torques
-      // signs are fitted manually
-      siku.es[c.i1].F -= vec2_to_vec3( F );
-      siku.es[c.i1].N -= torque1;
-
-      siku.es[c.i2].F += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
-      siku.es[c.i2].N += torque2;
-
-      // Joint destruction
-      double t = (p2-p1).abs() *
-          1. / ( vec3_to_vec2(e2_to_e1 * NORTH).abs() );
-          //2.0 / ( p1.abs() + (p2 - vec3_to_vec2( e2_to_e1 * NORTH)).abs() );
+  r.F2 += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
+  r.N2 += torque2;
 
-      c.durability -= (t > epsilon) ? t * sigma : 0.;
-    }
+  // Joint destruction
+  double t = (p2-p1).abs() *
+      1. / ( vec3_to_vec2(e2_to_e1 * NORTH).abs() );
+      //2.0 / ( p1.abs() + (p2 - vec3_to_vec2( e2_to_e1 * NORTH)).abs() );
 
+  b.durability -= (t > epsilon) ? t * sigma : 0.;
 }
 
 // -----------------------------------------------------------------------
 
 /// UNDONE!
-void _hopkins_frankenstein( ContactDetector::Contact& c, Globals& siku )
-{
-  // TODO: such errors should be removed by removing their reason
-  if(
-//      (siku.es[c.i1].flag & Element::F_ERRORED) ||
-//      (siku.es[c.i2].flag & Element::F_ERRORED) ||
-  // No need to calculate interaction for two steady polygons
-  // TODO: reconsider runtime fastened ice
-      ( (siku.es[c.i1].flag & Element::F_STEADY) &&
-          (siku.es[c.i2].flag & Element::F_STEADY) ) )
-    return;
-
-  if( c.type != ContType::JOINT )
-    {
-      _collision( siku, c ); // collision forces
-    }
-  else  // <=> if( c.type == ContType::JOINT ) // Hopkins` physics
-    {
-      Element& e1 = siku.es[c.i1], e2 = siku.es[c.i2];
+void _hopkins_frankenstein( ContactDetector::Contact& c,
+                            ContactDetector::Bond& b, Globals& siku,
+                            Reaction& r )
+{
+  Element& e1 = siku.es[c.i1], & e2 = siku.es[c.i2];
 
-      // coordinates transformation matrixes (local systems of two elements)
-      mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-      mat3d e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+  // coordinates transformation matrixes (local systems of two elements)
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+  mat3d e1_to_e2 = glm::transpose( e2_to_e1 );
 
-      // test for polygons convexity
-      _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2 );
+  // test for polygons convexity
+  _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2, r );
 
-      // -------------------------------------------------------------------
+  // -------------------------------------------------------------------
 
-      // physical constants (from python scenario)
-      double K = siku.phys_consts["elasticity"],
-             Kw = siku.phys_consts["bendability"],
-             sigma = siku.phys_consts["solidity"],
-             epsilon = siku.phys_consts["tensility"];
+  // physical constants (from python scenario)
+  double K = siku.pc.elasticity,
+         Kw = siku.pc.bendability,
+         sigma = siku.pc.solidity,
+         epsilon = siku.pc.tensility;
 
-      // calculating forces and torques (this method seems to be working wrong)
-      vec2d p11 = vec3_to_vec2( siku.es[c.i1].P[c.v11] );
-      vec2d p12 = vec3_to_vec2( siku.es[c.i1].P[c.v12] );
-      vec2d p21 = vec3_to_vec2( e2_to_e1 * siku.es[c.i2].P[c.v21] );
-      vec2d p22 = vec3_to_vec2( e2_to_e1 * siku.es[c.i2].P[c.v22] );
-      vec2d X;
+  // calculating forces and torques (this method seems to be working wrong)
+  vec2d p11 = vec3_to_vec2( siku.es[c.i1].P[b.v11] );
+  vec2d p12 = vec3_to_vec2( siku.es[c.i1].P[b.v12] );
+  vec2d p21 = vec3_to_vec2( e2_to_e1 * siku.es[c.i2].P[b.v21] );
+  vec2d p22 = vec3_to_vec2( e2_to_e1 * siku.es[c.i2].P[b.v22] );
+  vec2d X;
 
 //      double sinX = cross( (p12-p11).ort(), ( p21-p22 ).ort() );
 //      double cosX = dot( (p12-p11).ort(), ( p21-p22 ).ort() );
 
-      double Al = 0.5 * cross( p12 - X, p21 - X );
-      double Ar = 0.5 * cross( p22 - X, p11 - X );
-      vec2d Cl = (p12 + p21 + X) / 3.;
-      vec2d Cr = (p22 + p11 + X) / 3.;
+  double Al = 0.5 * cross( p12 - X, p21 - X );
+  double Ar = 0.5 * cross( p22 - X, p11 - X );
+  vec2d Cl = (p12 + p21 + X) / 3.;
+  vec2d Cr = (p22 + p11 + X) / 3.;
 
-      vec2d r12 = vec3_to_vec2( e2_to_e1 * NORTH );
-      vec2d Fl = Al * siku.planet.R * K * r12.ort();
-      vec2d Fr = Ar * siku.planet.R * K * r12.ort();
+  vec2d r12 = vec3_to_vec2( e2_to_e1 * NORTH );
+  vec2d Fl = Al * siku.planet.R * K * r12.ort();
+  vec2d Fr = Ar * siku.planet.R * K * r12.ort();
 
-      vec2d F = Fl + Fr;
+  vec2d F = Fl + Fr;
 
-      double torque1 = Kw * siku.planet.R_rec *
-          ( cross( Cl, Fl ) + cross( Cr, Fr ) );
+  double torque1 = Kw * siku.planet.R_rec *
+      ( cross( Cl, Fl ) + cross( Cr, Fr ) );
 
-      double torque2 = Kw * siku.planet.R_rec *
-                ( cross( r12 - Cl, Fl ) + cross( r12 - Cr, Fr ) );
+  double torque2 = Kw * siku.planet.R_rec *
+            ( cross( r12 - Cl, Fl ) + cross( r12 - Cr, Fr ) );
 
-      c.area = Ar > 0 ? Ar : 0.
-             + Al > 0 ? Al : 0.;
+  c.area = Ar > 0 ? Ar : 0.
+         + Al > 0 ? Al : 0.;
 
-      // applying forces and torques
-      // signs are fitted manually
-      siku.es[c.i1].F -= vec2_to_vec3( F );
-      siku.es[c.i1].N -= torque1;
+  // applying forces and torques
+  // signs are fitted manually
+  r.F1 -= vec2_to_vec3( F );
+  r.N1 -= torque1;
 
-      siku.es[c.i2].F += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
-      siku.es[c.i2].N += torque2;
+  r.F2 += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
+  r.N2 += torque2;
 
-      // Joint destruction
+  // Joint destruction
 //      double t = (abs(Al) + abs(Ar)) / ( siku.es[c.i1].A + siku.es[c.i2].A );
-//      c.durability -= (t > epsilon) ? t * sigma : 0.;
-    }
+//      b.durability -= (t > epsilon) ? t * sigma : 0.;
 }
 
 // -----------------------------------------------------------------------
 
-void _distributed_springs( ContactDetector::Contact& c, Globals& siku )
+void _distributed_springs( ContactDetector::Contact& c,
+                           ContactDetector::Bond& b, Globals& siku,
+                           Reaction& r )
 {
-  // TODO: such errors should be removed by removing their reason
-  if(
-//      (siku.es[c.i1].flag & Element::F_ERRORED) ||
-//      (siku.es[c.i2].flag & Element::F_ERRORED) ||
-  // No need to calculate interaction for two steady polygons
-  // TODO: reconsider runtime fastened ice
-      ( (siku.es[c.i1].flag & Element::F_STEADY) &&
-          (siku.es[c.i2].flag & Element::F_STEADY) ) )
-      return;
+  // broken joint waiting for conversion into collision
+  if( b.durability <= 0. )
+    return;
 
-  if( c.type != ContType::JOINT )
-    {
-      _collision( siku, c ); // collision forces
-    }
-  else if( c.durability > 0. ) // <=> if( c.type == ContType::JOINT )
-    {
-      Element &e1 = siku.es[c.i1], &e2 = siku.es[c.i2];
+  Element &e1 = siku.es[c.i1], &e2 = siku.es[c.i2];
 
-      // coordinates transformation matrixes (local systems of two elements)
-      mat3d e2_to_e1 = loc_to_loc_mat( e1.q, e2.q );
-      mat3d e1_to_e2 = loc_to_loc_mat( e2.q, e1.q );
+  // coordinates transformation matrixes (local systems of two elements)
+  mat3d e2_to_e1 = loc_to_loc_mat( e1.R, e2.R );
+  mat3d e1_to_e2 = glm::transpose( e2_to_e1 );
 
-      // test for polygons convexity
-      _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2 );
+  // test for polygons convexity
+  _err_n_land_test( e1, e2, e2_to_e1, e1_to_e2, r );
 
-      // -------------------------------------------------------------------
+  // -------------------------------------------------------------------
 
-      // physical constants (from python scenario)
-      double K = - siku.phys_consts["elasticity"], // NOTE THE SIGN!
-             Kw = siku.phys_consts["bendability"],
-             sigma = siku.phys_consts["solidity"],
-             epsilon = siku.phys_consts["tensility"];
+  // physical constants (from python scenario)
+  double K = - siku.pc.elasticity, // NOTE THE SIGN!
+         Kw = siku.pc.bendability,
+         sigma = siku.pc.solidity,
+         epsilon = siku.pc.tensility;
 
-      // direct and reversed planet radius shortcuts
-      double &R = siku.planet.R, &R_ = siku.planet.R_rec;
+  // direct and reversed planet radius shortcuts
+  double &R = siku.planet.R, &R_ = siku.planet.R_rec;
 
-      vec3d tv1, tv2; // just some temporals
+  vec3d tv1, tv2; // just some temporals
 
-      // original contact points considering current shift of elements
-      vec2d p1 = c.p1, p2 = c.p2,
-            p3 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( c.p3 ) ),
-            p4 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( c.p4 ) );
+  // original contact points considering current shift of elements
+  vec2d p1 = b.p1, p2 = b.p2,
+        p3 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( b.p3 ) ),
+        p4 = vec3_TO_vec2( e2_to_e1 * vec2_TO_vec3( b.p4 ) );
 
-      // IMPROVE: make proper check
-//      assert( c.durability > 0. );
-      VERIFY( (c.durability>0.) , "in dist spring" );
+  // IMPROVE: make proper check
+//      assert( b.durability > 0. );
+  VERIFY( (b.durability>0.) , "in dist spring" );
 
-      // some additional variables to avoid unnecessary functions` calls
-//      double hardness     = K * c.init_len * c.durability * R
-//             rotatability = K * c.init_len / c.init_size * c.durability * 1./12.;
-      double hardness = K * c.init_len / c.init_size * c.durability * R,
-             rotablty = K * c.init_len / c.init_size * c.durability * 1./12.;
+  // some additional variables to avoid unnecessary functions` calls
+//      double hardness     = K * b.init_len * b.durability * R
+//             rotatability = K * b.init_len / b.init_size * b.durability * 1./12.;
+  double hardness = K * b.init_len / b.init_size * b.durability * R,
+         rotablty = K * b.init_len / b.init_size * b.durability * 1./12.;
 
-      vec2d dr1 = p4 - p1,
-            dr2 = p3 - p2;
-      double dl1 = abs( dr1 ), dl2 = abs( dr2 );
+  vec2d dr1 = p4 - p1,
+        dr2 = p3 - p2;
+  double dl1 = abs( dr1 ), dl2 = abs( dr2 );
 
-      double mom1, mom2;
+  double mom1, mom2;
 
-      // The Force itself
-      vec2d F = hardness * (dr1 + dr2) * 0.5;
+  // The Force itself
+  vec2d F = hardness * (dr1 + dr2) * 0.5;
 
-      // combined torques
-      vec2d r12 = vec3_TO_vec2( e2_to_e1 * NORTH );
-      mom1 = Kw * ( R_ * cross( (p1 + p2) * 0.5, F ) +          //traction
-                    rotablty * cross( p1 - p2, dr1 - dr2 ) );   //couple
-      mom2 = Kw * ( R_ * cross( (p3 + p4) * 0.5 - r12, F ) +    //traction
-                    rotablty * cross( p3 - p4, dr2 - dr1 ) );   //couple
+  // combined torques
+  vec2d r12 = vec3_TO_vec2( e2_to_e1 * NORTH );
+  mom1 = Kw * ( R_ * cross( (p1 + p2) * 0.5, F ) +          //traction
+                rotablty * cross( p1 - p2, dr1 - dr2 ) );   //couple
+  mom2 = Kw * ( R_ * cross( (p3 + p4) * 0.5 - r12, F ) +    //traction
+                rotablty * cross( p3 - p4, dr2 - dr1 ) );   //couple
 
-      VERIFY( F, "in dist_spring");
-      VERIFY( mom1, "in dist_spring");
-      VERIFY( mom2, "in dist_spring");
+  VERIFY( F, "in dist_spring");
+  VERIFY( mom1, "in dist_spring");
+  VERIFY( mom2, "in dist_spring");
 
-      // applying forces and torques
-      // signs are fitted manually
-      e1.F -= vec2_to_vec3( F );
-      e1.N -= mom1;
+  // applying forces and torques
+  // signs are fitted manually
+  r.F1 -= vec2_to_vec3( F );
+  r.N1 -= mom1;
 
-      e2.F += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
-      e2.N += mom2;
+  r.F2 += lay_on_surf( e1_to_e2 * vec2_to_vec3( F ) );
+  r.N2 += mom2;
 
-      VERIFY( e1.F, "1in dist_spring");
-      VERIFY( e2.F, "1in dist_spring");
+  VERIFY( r.F1, "1in dist_spring");
+  VERIFY( r.F2, "1in dist_spring");
 
-      // durability change - joint destruction
-      double r_size = 1. / c.init_size, // reversed size
-             dmax = max( dl1, dl2 ),    // maximal stretch
-             dave = (dl1 + dl2) * 0.5;  // average stretch
+  // durability change - joint destruction
+  double r_size = 1. / b.init_size, // reversed size
+         dmax = max( dl1, dl2 ),    // maximal stretch
+         dave = (dl1 + dl2) * 0.5;  // average stretch
 
-      // TODO: discuss time scaling
-      c.durability -= siku.time.get_dt() *
-          ( ( dmax * r_size > epsilon ) ? dave * r_size * sigma : 0. );
+  // TODO: discuss time scaling
+  b.durability -= siku.time.get_dt() *
+      ( ( dmax * r_size > epsilon ) ? dave * r_size * sigma : 0. );
 
 //// may be required in 'collision' contact type
-//      if( c.durability < 0.05 )
+//      if( b.durability < 0.05 )
 //        {
 //          std::vector<vec2d> loc_P1;  // e1.P vertices in local 2d coords
 //          std::vector<vec2d> loc_P2;  // e2.P vertices in local 2d coords
@@ -579,34 +1027,31 @@ void _distributed_springs( ContactDetector::Contact& c, Globals& siku )
 //
 //          c.area = area;
 //        }
-
-    }
-
 }
 
 // -----------------------------------------------------------------------
 
 void _err_n_land_test( Element &e1, Element &e2,
-                       mat3d& e2_to_e1, mat3d& e1_to_e2 )
+                       mat3d& e2_to_e1, mat3d& e1_to_e2, Reaction& r )
 {
-  std::vector<vec2d> loc_P1;  // e1.P vertices in local 2d coords
-  std::vector<vec2d> loc_P2;  // e2.P vertices in local 2d coords
+  size_t cap = scratch.capacity();
 
   // polygons in local (e1) coords
-  for( auto& p : e1.P ) loc_P1.push_back( vec3_TO_vec2( p ) );
-  for( auto& p : e2.P ) loc_P2.push_back( vec3_TO_vec2( e2_to_e1 * p ) );
+  _local_poly( e2, e2_to_e1 );
+  _scratch_check( cap );
 
   // check for errors
 //  if( errored( loc_P1 ) )   e1.flag |= Element::F_ERRORED;
 //  if( errored( loc_P2 ) )   e2.flag |= Element::F_ERRORED;
 
-  _fasten( e1, e2, 0.0, loc_P1, loc_P2 );
+  _fasten( e1, e2, 0.0, e1.coll(), scratch.P2, r );
 }
 
 // -----------------------------------------------------------------------
 
 void _fasten( Element &e1, Element &e2, double area,
-                const vector<vec2d>& l1, const vector<vec2d>& l2 )
+                const vector<vec2d>& l1, const vector<vec2d>& l2,
+                Reaction& r )
 {
   // if one element is shore (static but not fastened):
   // check fastening condition
@@ -615,24 +1060,24 @@ void _fasten( Element &e1, Element &e2, double area,
     {
       // minimal areas for comparison
       double ma = min( e1.A, e2.A );
-      e1.OAM = min( e1.OAM, ma );
-      e2.OAM = min( e2.OAM, ma );
+      r.oam = ma;
 
       // current overlap area accumulation (optimized in case of precalculated
       // area
       if( area )
         {
-          e1.OA += area;
-          e2.OA += area;
+          r.oa += area;
         }
       else
         {
-          vector<vec2d> interPoly;
-          if( intersect( l1, l2, interPoly, nullptr, nullptr, &area ) > 2 )
-            {
-              e1.OA += area;
-              e2.OA += area;
-            }
+          size_t cap = scratch.capacity();
+          int res = intersect_rourke( l1.data(), l1.size(),
+                                      l2.data(), l2.size(),
+                                      scratch.inter, nullptr, nullptr, &area );
+          _scratch_check( cap );
+
+          if( res > 2 )
+            r.oa += area;
         }
     }
 }
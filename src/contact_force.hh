@@ -42,6 +42,24 @@
 //! \brief Calculate elements` interaction forces.
 void contact_forces( Globals& siku );
 
+//! \brief Amount of narrow phase scratch buffers reallocations since start.
+//! Should stop growing after the first steps.
+unsigned long contact_scratch_grows();
+
+//! \brief Separating axis test statistics since start (only with
+//! --enable-contact-stats, zeros otherwise): 'hits' - pair was
+//! separated by the witness axis of previous step, 'misses' - by another
+//! axis, 'overlaps' - not separated (full intersection was calculated).
+void contact_sat_stats( unsigned long& hits, unsigned long& misses,
+                        unsigned long& overlaps );
+
+//! \brief Narrow phase precision validation statistics (only with
+//! --enable-precision-check, zeros otherwise): amount of checked polygons
+//! intersections, amount of them with different overlap status and maximal
+//! relative overlap area difference from full double precision results.
+void contact_precision_stats( unsigned long& checked,
+                              unsigned long& mismatched, double& max_err );
+
 // Deprecated: built in 'contact_forces' for better performance
 ////! Function for calculating two elements interaction. Changes both elements
 ////! so should be used once per pair of elements.
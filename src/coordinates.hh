@@ -53,6 +53,29 @@ namespace Coordinates
     return glm::mat3_cast( q ) * v;
   }
 
+  //! \brief Returns local (x, y, z) representation of global (x, y, z) for
+  //! cached rotation matrix 'R' (R = mat3_cast( q ), see Element::R)
+  //!
+  //! \param[in] R local to global rotation matrix
+  //! \param[in] global (x, y, z)
+  inline vec3d
+  glob_to_loc ( const mat3d& R, const vec3d& v )
+  {
+    return glm::transpose( R ) * v;
+  }
+
+  //! \brief Returns rotation matrix for converting vectors (x, y, z) from
+  //! local 'Rs' coords to local 'Rd' coords (cached rotation matrixes of
+  //! positions, see Element::R)
+  //!
+  //! \param[in] Rd destination rotation matrix
+  //! \param[in] Rs source rotation matrix
+  inline mat3d
+  loc_to_loc_mat ( const mat3d& Rd, const mat3d& Rs )
+  {
+    return glm::transpose( Rd ) * Rs;
+  }
+
   //! \brief Returns rotation matrix for converting vectors (x, y, z) from
   //! local 'qs' coords to local 'qd' coords
   //!
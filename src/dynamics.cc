@@ -19,44 +19,58 @@
 #include <iostream>
 
 void
-dynamics ( Globals& siku, const double dt )
+dynamics_element ( Globals& siku, const size_t i, const double dt )
 {
-  for ( auto & e : siku.es )
-    {
-//      if( e.flag & Element::F_ERRORED ) continue; // TODO: change or remove dis
+  auto& es = siku.es;
 
-      //cout<<"%%% "<<e.I<<endl;
-      //cout<<"%%% "<<e.m<<endl;
+  const unsigned int flag = es[i].flag;
+  vec3d &V = es.V[i], &W = es.W[i], &F = es.F[i];
 
-      if ( e.flag & Element::F_STATIC ) //continue;
-        {
-          e.W = {};
-          e.V = {};
-        }
+//      if( flag & Element::F_ERRORED ) continue; // TODO: change or remove dis
 
-      // first we create a vector of Super-Torque
-//      vec3d sT ( -e.F[1] / ( siku.planet.R * e.m ),
-//                 e.F[0] / ( siku.planet.R * e.m ), e.N / e.I );
-      //// manual drag added
-      double c = 0.0 * siku.planet.R_rec * siku.time.get_dt(); //time scaling coz pseudoforce
-      vec3d sT ( -e.F[1] / ( siku.planet.R * e.m ),
-                 e.F[0] / ( siku.planet.R * e.m ), e.N / e.I - c * e.W.z );
+  //cout<<"%%% "<<es.I[i]<<endl;
+  //cout<<"%%% "<<es.m[i]<<endl;
 
-      VERIFY( sT, string("dyn ") + to_string(e.m) + string(" | ") + to_string(e.F[0]) + "  " + to_string(e.F[1]) );
+  // sleeping elements stay at rest until woken up
+  if ( flag & Element::F_SLEEPING ) return;
 
-     // sT = vec3d ( -e.F[1] , e.F[0] , e.N / e.I - c * e.W.z );
-      //vec3d sT = nullvec;
+  if ( flag & Element::F_STATIC ) //continue;
+    {
+      W = {};
+      V = {};
+    }
 
-      // and increment the angular velocity using it (if not steady)
-      if( ! ( e.flag & Element::F_STEADY ) )
-        e.W += sT * dt;
+  // first we create a vector of Super-Torque
+//      vec3d sT ( -F[1] / ( siku.planet.R * es.m[i] ),
+//                 F[0] / ( siku.planet.R * es.m[i] ), es.N[i] / es.I[i] );
+  //// manual drag added
+  double c = 0.0 * siku.planet.R_rec * siku.time.get_dt(); //time scaling coz pseudoforce
+  vec3d sT ( -F[1] * es.iRm[i],
+             F[0] * es.iRm[i],
+             es.N[i] * es.iI[i] - c * W.z );
 
-      VERIFY( e.W, "dyn: W");
+  VERIFY( sT, string("dyn ") + to_string(es.m[i]) + string(" | ") + to_string(F[0]) + "  " + to_string(F[1]) );
 
-      // calculating local speed
-      //e.V = vec3d( e.W.y , -e.W.x , 0. );
-      e.V = vec3d( e.W.y * siku.planet.R , -e.W.x * siku.planet.R, 0. );
-      VERIFY(e.V, "V in dyn");
+ // sT = vec3d ( -F[1] , F[0] , es.N[i] / es.I[i] - c * W.z );
+  //vec3d sT = nullvec;
 
-    }
+  // and increment the angular velocity using it (if not steady)
+  if( ! ( flag & Element::F_STEADY ) )
+    W += sT * dt;
+
+  VERIFY( W, "dyn: W");
+
+  // calculating local speed
+  //V = vec3d( W.y , -W.x , 0. );
+  V = vec3d( W.y * siku.planet.R , -W.x * siku.planet.R, 0. );
+  VERIFY(V, "V in dyn");
+}
+
+// --------------------------------------------------------------------------
+
+void
+dynamics ( Globals& siku, const double dt )
+{
+  for ( size_t i = 0; i < siku.es.size(); ++i )
+    dynamics_element ( siku, i, dt );
 }
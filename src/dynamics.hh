@@ -16,4 +16,8 @@
 void
 dynamics ( Globals& siku, const double dt );
 
+//! \brief dynamics update of a single element at position 'i'
+void
+dynamics_element ( Globals& siku, const size_t i, const double dt );
+
 #endif      /* DYNAMICS_HH */
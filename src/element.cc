@@ -25,16 +25,18 @@
  */
 
 #include <cmath>
+#include <algorithm>
 
 #include "element.hh"
 #include "coordinates.hh"
+#include "errors.hh"
 
 using namespace Coordinates;
 using namespace Geometry;
 
 bool Element::contains( const vec3d& p )
 {
-  vec3d point = glob_to_loc( q, p );
+  vec3d point = glob_to_loc( R, p );
 
   vec3d PP;// = P[1]-P[0];
   vec3d PO;// = point - P[0];
@@ -69,6 +71,188 @@ bool Element::contains( const vec3d& p )
   return true;
 }
 
+// --------------------------------------------------------------------------
+
+void Element::update_orient( const quat& q )
+{
+  R = glm::mat3_cast( q );
+  Glob = R * NORTH;
+
+  lat = norm_lat( M_PI/2. - atan2( sqrt( Glob.x*Glob.x + Glob.y*Glob.y ),
+                                   Glob.z ) );
+  lon = norm_lon( atan2( Glob.y, Glob.x ) );
+}
+
+// --------------------------------------------------------------------------
+
+void Element::set_orient( const mat3d& M, double la, double lo )
+{
+  R = M;
+  Glob = R[2];                  // R * NORTH
+
+  lat = norm_lat( la );
+  lon = norm_lon( lo );
+}
+
+// --------------------------------------------------------------------------
+
+void Element::update_frame()
+{
+  const size_t n = P.size();
+  const bool first = P2.size() != n;
+
+  // no reallocations after the first call
+  P2.resize( n );
+  E2.resize( n );
+  N2.resize( n );
+
+  r2 = 0.;
+  for( size_t i = 0; i < n; ++i )
+    {
+      P2[i] = vec3_TO_vec2( P[i] );
+      r2 = max( r2, P2[i].abs() );
+    }
+
+  for( size_t i = 0; i < n; ++i )
+    {
+      E2[i] = P2[ ( i + 1 ) % n ] - P2[i];
+
+      // CCW polygon: outer side is on the right. Zero edges get zero normal
+      double l = E2[i].abs();
+      N2[i] = l > 0. ? rot_90_cw( E2[i] ) / l : vec2d();
+    }
+
+  if( first ) fit_box();
+}
+
+// --------------------------------------------------------------------------
+
+void Element::fit_box()
+{
+  const vector<vec2d>& Q = coll();
+  const size_t n = Q.size();
+  double best = -1.;
+
+  // minimal area rectangle of convex polygon has a side along one of its
+  // edges: checking all of them
+  for( size_t k = 0; k < n; ++k )
+    {
+      vec2d ek = Q[ ( k + 1 ) % n ] - Q[k];
+      double l = ek.abs();
+      if( l == 0. ) continue;
+
+      vec2d u = ek / l, v = rot_90_ccw( u );
+      double u0 = dot( u, Q[0] ), u1 = u0, v0 = dot( v, Q[0] ), v1 = v0;
+      for( auto& p : Q )
+        {
+          double pu = dot( u, p ), pv = dot( v, p );
+          u0 = min( u0, pu ); u1 = max( u1, pu );
+          v0 = min( v0, pv ); v1 = max( v1, pv );
+        }
+
+      double area = ( u1 - u0 ) * ( v1 - v0 );
+      if( best < 0. || area < best )
+        {
+          best = area;
+          obb_c = u * ( 0.5 * ( u0 + u1 ) ) + v * ( 0.5 * ( v0 + v1 ) );
+          obb_a = u * ( 0.5 * ( u1 - u0 ) );
+          obb_b = v * ( 0.5 * ( v1 - v0 ) );
+        }
+    }
+
+  // degenerated polygon (all vertices coincide): box around bounding circle
+  if( best < 0. )
+    {
+      obb_c = vec2d();
+      obb_a = vec2d{ r2, 0. };
+      obb_b = vec2d{ 0., r2 };
+    }
+}
+
+// --------------------------------------------------------------------------
+
+// distance from point to segment ab
+inline double _seg_dist( const vec2d& p, const vec2d& a, const vec2d& b )
+{
+  vec2d ab = b - a;
+  double l2 = dot( ab, ab );
+  double t = l2 > 0. ? dot( p - a, ab ) / l2 : 0.;
+  t = t < 0. ? 0. : ( t > 1. ? 1. : t );
+  return ( a + ab * t - p ).abs();
+}
+
+void Element::build_proxy( size_t nmax, double err )
+{
+  C2.clear();
+  CN2.clear();
+  proxy_r = 0.;
+
+  if( nmax < 3 || P2.size() <= nmax )
+    {
+      fit_box();
+      return;
+    }
+
+  C2 = convex_hull( P2 );
+  if( C2.size() > 1 && C2.back() == C2.front() ) C2.pop_back();
+
+  const double lim = err * r2;
+
+  while( C2.size() > nmax )
+    {
+      const size_t n = C2.size();
+      size_t best = n;
+      double best_d = lim;
+      vec2d best_x {};
+
+      // edge (k, k+1) is removed by extending edges (k-1, k) and (k+1, k+2)
+      // up to their intersection 'x': new polygon still contains old one
+      for( size_t k = 0; k < n; ++k )
+        {
+          const vec2d& a = C2[ ( k + n - 1 ) % n ], & b = C2[k],
+                     & c = C2[ ( k + 1 ) % n ], & d = C2[ ( k + 2 ) % n ];
+          vec2d e1 = b - a, e3 = d - c;
+
+          double cr = cross( e1, e3 );
+          if( cr <= 0. ) continue;  // neighbour edges do not converge
+
+          vec2d x = a + e1 * ( cross( c - a, e3 ) / cr );
+
+          // error: distance from new vertex to original polygon
+          double dist = _seg_dist( x, P2.back(), P2.front() );
+          for( size_t i = 0; i + 1 < P2.size(); ++i )
+            dist = min( dist, _seg_dist( x, P2[i], P2[i + 1] ) );
+
+          if( dist <= best_d )
+            {
+              best = k;
+              best_d = dist;
+              best_x = x;
+            }
+        }
+
+      if( best == n ) break;  // no more edges can be removed within error
+
+      C2[ best ] = best_x;
+      C2.erase( C2.begin() + ( best + 1 ) % n );
+    }
+
+  CN2.resize( C2.size() );
+  for( size_t i = 0; i < C2.size(); ++i )
+    {
+      vec2d e = C2[ ( i + 1 ) % C2.size() ] - C2[i];
+      double l = e.abs();
+      CN2[i] = l > 0. ? rot_90_cw( e ) / l : vec2d();
+    }
+
+  // detection gates must contain the proxy, not only P2
+  for( auto& c : C2 )
+    proxy_r = max( proxy_r, c.abs() - r2 );
+  fit_box();
+}
+
+// --------------------------------------------------------------------------
+
 //try to reload std::swap for sort((
 //#include <utility>
 //
@@ -136,3 +320,73 @@ bool Element::contains( const vec3d& p )
 //  std::swap( E1.N, E2.N );
 //
 //}
+
+// ==========================================================================
+
+void ElementStore::resize( size_t n )
+{
+  items.resize( n );
+  q.resize( n, quat( 1., 0., 0., 0. ) );
+  V.resize( n, nullvec3d );
+  W.resize( n, nullvec3d );
+  F.resize( n, nullvec3d );
+  N.resize( n, 0. );
+  m.resize( n, 0. );
+  I.resize( n, 0. );
+  iRm.resize( n, 0. );
+  iI.resize( n, 0. );
+}
+
+// --------------------------------------------------------------------------
+
+// gathers 'a' by permutation into temporal array and swaps
+template< typename A >
+static void _gather( A& a, const vector<size_t>& from )
+{
+  A t( a.size() );
+  for( size_t k = 0; k < from.size(); ++k )
+    t[k] = std::move( a[ from[k] ] );
+  a.swap( t );
+}
+
+void ElementStore::permute( const vector<size_t>& from )
+{
+  _gather( items, from );
+  _gather( q, from );
+  _gather( V, from );
+  _gather( W, from );
+  _gather( F, from );
+  _gather( N, from );
+  _gather( m, from );
+  _gather( I, from );
+  _gather( iRm, from );
+  _gather( iI, from );
+}
+
+// --------------------------------------------------------------------------
+
+void ElementStore::bind_verts()
+{
+  auto by_elem = []( const Element::vertex& a, const Element::vertex& b )
+    { return a.elem_id < b.elem_id; };
+
+  if( !std::is_sorted( verts.begin(), verts.end(), by_elem ) )
+    std::stable_sort( verts.begin(), verts.end(), by_elem );
+
+  for( auto& e : items )
+    e.P = Element::Verts();
+
+  for( size_t k = 0; k < verts.size(); )
+    {
+      const size_t i = verts[k].elem_id;
+      if( i >= items.size() )
+        fatal( 1, "vertex of unknown element %lu", (unsigned long) i );
+
+      size_t n = 1;
+      while( k + n < verts.size() && verts[k + n].elem_id == i ) ++n;
+
+      items[i].P.p = verts.data() + k;
+      items[i].P.n = n;
+      k += n;
+    }
+}
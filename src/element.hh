@@ -35,16 +35,19 @@ using namespace std;
 
 #include "siku.hh"
 #include "coordinates.hh"
+#include "auxutils.hh"
 
 //! \brief Ice element class: representation for a single ice element
 class Element
 {
 public:
-  //! \brief struct for marking and saving vertices
+  //! \brief struct for marking and saving vertices. Position goes first:
+  //! records are 32 bytes, so positions in the aligned vertices pool of
+  //! 'ElementStore' are aligned for vector loads
   struct vertex
   {
-    unsigned long elem_id;
     vec3d pos;
+    unsigned long elem_id;
 
     vertex(const vec3d& v = {}, const size_t& id = 0)
     //: pos( v ), elem_id( id ) {} // <- dis spawns a lot of warnings
@@ -54,6 +57,36 @@ public:
     }
   };
 
+  //! \brief read only view of element`s vertices: a span of 'vertex'
+  //! records in the vertices pool of 'ElementStore'
+  class Verts
+  {
+  public:
+    //! \brief iterator over positions of vertices
+    class iterator
+    {
+    public:
+      iterator( const vertex* p ) : p( p ) {}
+      inline const vec3d& operator* () const { return p->pos; }
+      inline iterator& operator++ () { ++p; return *this; }
+      inline bool operator!= ( const iterator& o ) const { return p != o.p; }
+    private:
+      const vertex* p;
+    };
+
+    inline size_t size() const { return n; }
+    inline bool empty() const { return !n; }
+    inline const vec3d& operator[] ( size_t i ) const { return p[i].pos; }
+    inline iterator begin() const { return iterator( p ); }
+    inline iterator end() const { return iterator( p + n ); }
+
+  private:
+    friend class ElementStore;
+
+    const vertex* p {nullptr};
+    size_t n {0};
+  };
+
   //! \brief flag state for free body element
   static const unsigned int F_FREE   {0x1};
   //! \brief flag state for steady body element, that remains same v
@@ -79,6 +112,16 @@ public:
   //! \brief flag for runtime land-fastened ice elements
   static const unsigned int F_FASTENED {0x80};  // aka 128
 
+  //! \brief flag for sleeping elements: a calm island of elements is
+  //! skipped by all phases until it is woken up (see 'sleeping')
+  static const unsigned int F_SLEEPING {0x100};  // aka 256
+
+  //! \brief technical flag for elements whose mass properties ('gh', 'imat',
+  //! 'A' or their material) were changed: mass, moment of inertia and
+  //! their inverses are recomputed by 'mproperties'. Must be set by any
+  //! code changing them (see 'Globals::mass_changed')
+  static const unsigned int F_MASS_DIRTY {0x200};  // aka 512
+
   //! \brief flag state for elements with any kind of error properties
   static const unsigned int F_ERRORED {0x80000000};
 
@@ -93,28 +136,29 @@ public:
   size_t mon_ind { 0 };               //!< monitor function index
   size_t con_ind { 0 };               //!< control function index
 
-  size_t id { 0 };                    //!< id of element, matches it`s index
-                                      //! in Globals.es
+  size_t id { 0 };                    //!< id of element, its index
+                                      //! in Globals.es is Globals.slot[id]
 
   // --------------- Rapidly changing parameters ----------------------
 
-  //! \brief "Pendulum" orientation: defines the position of the ice
-  //! element on a sphere
-  quat q;
+  // Dynamic state (orientation q, velocities V and W, force F, torque N,
+  // mass m, moment of inertia I and their inverses) is kept in ElementStore
+  // arrays
 
   vec3d Glob;           //!< global position in (x, y, z)
-  vec3d V{};            //!< local surface velocity (x, y, 0)
-
-  double m;             //!< kg, mass
-  double I;             //!< moment of inertia
 
-  vec3d W;              //!< 1/m, angular velocity in local coord.
-  vec3d F;              //!< N, net force vector in local frame
-  double N {0};         //!< N*m, torque value in local frame
+  mat3d R;              //!< rotation matrix of 'q' (local to global)
+  double lat {0};       //!< latitude of center (radians, normalized)
+  double lon {0};       //!< longitude of center (radians, normalized)
+                        //! (R, Glob, lat, lon are cached by 'update_orient')
 
   double OA {0};        //!< total relative overlap area with landfast !ice
   double OAM {0};       //!< minimal area of polygons for fastening checks
 
+  unsigned int calm {0};  //!< steps in a row below sleeping thresholds
+  size_t island {0};      //!< sleeping island id (valid with F_SLEEPING)
+  vec3d Fm {};            //!< mass force when fell asleep (for wake checks)
+
   // --------------- Not changing state parameters -------------------
 
   size_t imat;                  //!< material index
@@ -128,25 +172,179 @@ public:
 
   //OLD //vector<double> gh;
   double gh[ MAT_LAY_AMO ];     //!< g(h) thickness distribution
-  vector<vec3d> P;              //!< 1, local unit frame coords of
-                                //! vertices
+  Verts P;                      //!< 1, local unit frame coords of
+                                //! vertices (see 'ElementStore::verts')
+
+  // --------------- Cached local 2d frame (see 'update_frame') ---------
+
+  vector<vec2d> P2;             //!< vertices projected onto local plane
+  vector<vec2d> E2;             //!< edges: E2[i] = P2[i+1] - P2[i]
+  vector<vec2d> N2;             //!< outward unit normals of edges
+  double r2 {0};                //!< bounding radius of P2 around center
+
+  //! oriented bounding box of collision polygon 'coll()' (minimal area,
+  //! along one of the edges): center and two orthogonal half-axes. Built
+  //! when the frame is built for the first time (vertices do not move in
+  //! local frame) and rebuilt for the proxy
+  vec2d obb_c {}, obb_a {}, obb_b {};
+
+  //! collision proxy: simplified convex polygon containing P2 and its
+  //! outward unit edge normals. Empty if it was not built (see 'build_proxy')
+  vector<vec2d> C2, CN2;
+
+  //! how far the proxy reaches beyond bounding radius of P2 (0 without
+  //! proxy). Added to 'sbb_rmin' by all detection stages (see 'coll_r')
+  double proxy_r {0};
 
   // ------------------- METHODS: -------------------------------------
 
   //! Check if point (given inglobal x,y,z ) is inside the element
   bool contains( const vec3d& p );
 
+  //! Refreshes cached orientation (R, Glob, lat, lon) from element`s
+  //! orientation 'q'. Must be called after each change of 'q'.
+  void update_orient( const quat& q );
+
+  //! Sets cached orientation from rotation matrix 'M' of 'q' and not
+  //! normalized latitude 'la' and longitude 'lo' already computed for it
+  //! (batched path of 'update_orient', see 'position_block')
+  void set_orient( const mat3d& M, double la, double lo );
+
+  //! Refreshes cached 2d frame (P2, E2, N2, r2) from 'P'. Called once per
+  //! step in 'mproperties', so contact kernels do not project own vertices.
+  void update_frame();
+
+  //! Fits the oriented bounding box (obb_c, obb_a, obb_b) to 'coll()'.
+  void fit_box();
+
+  //! Builds collision proxy (C2, CN2) if P2 has more than 'nmax' vertices:
+  //! convex hull of P2 decimated by replacing edges with the intersection of
+  //! their neighbours while the proxy differs from P2 by less than
+  //! 'err' * r2. The error bound has priority over the vertices amount.
+  void build_proxy( size_t nmax, double err );
+
+  //! polygon for collisions (in local 2d frame): proxy if it was built,
+  //! P2 otherwise
+  inline const vector<vec2d>& coll() const { return C2.empty() ? P2 : C2; }
+
+  //! outward unit normals of 'coll()' edges
+  inline const vector<vec2d>& coll_n() const { return C2.empty() ? N2 : CN2; }
+
+  //! bounding radius of 'coll()': all detection stages test the same shape
+  inline double coll_r() const { return sbb_rmin + proxy_r; }
+
 //  Element()
 //  {
 //    P = vector<vec3d>(0);
 //  }
 
-  //! Destructor takes care about monitor and control functions
-  ~Element()
+  // No user-declared destructor: implicit move operations are needed to move
+  // records with their cached frames (see 'ElementStore::permute')
+};
+
+//====================================================================
+
+//! \brief Elements storage. Elements` records keep geometry and rarely
+//! changed data, while dynamic state of elements is kept in separate
+//! aligned arrays with the same positions, so dynamics passes stream only
+//! the data they use. All arrays are resized and permuted together.
+class ElementStore
+{
+public:
+  template< typename T >
+  using array = vector< T, auxutils::aligned_allocator< T > >;
+
+  //! \brief view of element at some position: its record and its state
+  struct Ref
+  {
+    Element& e;
+    quat& q;
+    vec3d& V;
+    vec3d& W;
+    vec3d& F;
+    double& N;
+    double& m;
+    double& I;
+    double& iRm;
+    double& iI;
+  };
+
+  //! \brief read only view of element
+  struct CRef
+  {
+    const Element& e;
+    const quat& q;
+    const vec3d& V;
+    const vec3d& W;
+    const vec3d& F;
+    const double& N;
+    const double& m;
+    const double& I;
+    const double& iRm;
+    const double& iI;
+  };
+
+  // ------------------------- dynamic state ------------------------------
+
+  array<quat> q;        //!< "Pendulum" orientation: defines the position
+                        //! of the ice element on a sphere
+  array<vec3d> V;       //!< local surface velocity (x, y, 0)
+  array<vec3d> W;       //!< 1/m, angular velocity in local coord.
+  array<vec3d> F;       //!< N, net force vector in local frame
+  array<double> N;      //!< N*m, torque value in local frame
+  array<double> m;      //!< kg, mass
+  array<double> I;      //!< moment of inertia
+  array<double> iRm;    //!< 1 / (planet.R * m), cached by 'mproperties'
+  array<double> iI;     //!< 1 / I, cached by 'mproperties'
+
+  // ---------------------------- geometry --------------------------------
+
+  //! vertices pool: vertices of all elements in the order of their IDs,
+  //! each element refers to its span by 'Element::P'. Saved as is. Must be
+  //! followed by 'bind_verts' after any change.
+  array<Element::vertex> verts;
+
+  // ------------------------------ access --------------------------------
+
+  inline size_t size() const { return items.size(); }
+  inline bool empty() const { return items.empty(); }
+
+  inline Element& operator[] ( size_t i ) { return items[i]; }
+  inline const Element& operator[] ( size_t i ) const { return items[i]; }
+
+  inline vector<Element>::iterator begin() { return items.begin(); }
+  inline vector<Element>::iterator end() { return items.end(); }
+  inline vector<Element>::const_iterator begin() const
+  { return items.begin(); }
+  inline vector<Element>::const_iterator end() const { return items.end(); }
+
+  inline Ref ref( size_t i )
   {
-    //if ( monitor ) delete monitor;
-    //if ( control ) delete control;
+    return Ref{ items[i], q[i], V[i], W[i], F[i], N[i], m[i], I[i],
+                iRm[i], iI[i] };
   }
+  inline CRef ref( size_t i ) const
+  {
+    return CRef{ items[i], q[i], V[i], W[i], F[i], N[i], m[i], I[i],
+                 iRm[i], iI[i] };
+  }
+
+  // ---------------------------- modification ----------------------------
+
+  //! \brief resizes all arrays, new elements have zero state
+  void resize( size_t n );
+
+  //! \brief moves elements: new position k gets element from position
+  //! from[k]. 'from' must be a permutation
+  void permute( const vector<size_t>& from );
+
+  //! \brief binds elements to their spans in 'verts' by vertices` elem_id,
+  //! which must be positions of elements (as while loading). Vertices are
+  //! grouped by elements if they were not.
+  void bind_verts();
+
+private:
+  vector<Element> items;
 };
 
 //====================================================================
@@ -24,95 +24,98 @@ inline void _drag_factors( Globals& siku, Element& e,
 {
   // yet simple scaling by constants from python. May me changed to
   // multiparametric algorithm later.
-  water_factor = e.anchority * siku.phys_consts["anchority"];
-  wind_factor  = e.windage   * siku.phys_consts["windage"];
+  water_factor = e.anchority * siku.pc.anchority;
+  wind_factor  = e.windage   * siku.pc.windage;
 }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+vec3d mass_force( Globals& siku, size_t i )
+{
+  Element& e = siku.es[i];
+  vec3d F {};
+
+  // force scaling
+  double wnd_fact, wat_fact;
+  _drag_factors( siku, e, wat_fact, wnd_fact );
+
+  //-------- WIND ----------
+
+  // interpolating wind speed near element`s mass center (cached
+  // position in terms lat-lon)
+  vec3d V = siku.wind.get_at_lat_lon_rad ( e.lat, e.lon );
+
+  // transforming to local coordinates
+  V = Coordinates::glob_to_loc( e.R, V );
+
+  // calculating local Force (draft)
+  F += V * abs( V ) * e.A * siku.planet.R2 * wnd_fact ;
+  VERIFY( F , "wind forces mass" );
+
+  //-------- WATER (yet steady) ----------
+
+  // calculating element`s speed in local coords
+  V = siku.es.V[i];
+  if(!_verify(abs(V)))
+          cout<<"-----"<<V<<endl;
+  VERIFY( abs(V) ,"V F_M ");
+
+
+  // interpolating currents speed
+  // !!check for earth.R scaling
+  vec3d W = siku.flows.get_at_lat_lon_rad ( e.lat, e.lon );
+  VERIFY( abs(W ),"1");
+  // transforming currents into local coords
+  W = Coordinates::glob_to_loc( e.R, W );
+  VERIFY( abs(W ),"2");
+
+  // velocity difference between ice element and water
+  W -= V;
+  VERIFY( abs(W ),"3");
+
+  // applying water forces
+  F += W * abs( W ) * e.A * siku.planet.R2 * wat_fact;
+  VERIFY( abs(W), "in f_m");
+  if(!_verify(abs(W))) cout<<"===="<<W<<endl;
+  VERIFY( F, string("water in forces mass ") + to_string(wat_fact)+
+          string("  ") + to_string(e.A) );
+
+  return F;
+}
+
+// --------------------------------------------------------------------------
+
 void forces_mass( Globals& siku )
 {
   for ( size_t i = 0; i < siku.es.size (); ++i )
     {
       if( siku.es[i].flag & Element::F_ERRORED //)
           || siku.es[i].flag & Element::F_STEADY    // coz steady and static
-          || siku.es[i].flag & Element::F_STATIC )  // won`t change their speed
+          || siku.es[i].flag & Element::F_STATIC    // won`t change their speed
+          || siku.es[i].flag & Element::F_SLEEPING )
         continue;
 
-      // i just don`t like range-based loops
-      auto & e = siku.es[i];
-
-      // force scaling
-      double wnd_fact, wat_fact;
-      _drag_factors( siku, e, wat_fact, wnd_fact );
-
-      //-------- WIND ----------
-
-      // acquiring element` position in terms lat-lon
-      double lat, lon;
-      Coordinates::sph_by_quat ( e.q, &lat, &lon );
-      
-      // interpolating wind speed near element`s mass center
-      vec3d V = siku.wind.get_at_lat_lon_rad ( Coordinates::norm_lat( lat ),
-                                               Coordinates::norm_lon( lon ) );
-
-      // transforming to local coordinates
-      V = Coordinates::glob_to_loc( e.q, V );
-
-      // calculating local Force (draft)
-      e.F += V * abs( V ) * e.A * siku.planet.R2 * wnd_fact ;
-      VERIFY( e.F , "wind forces mass" );
-
-      //-------- WATER (yet steady) ----------
-
-      // calculating element`s speed in local coords
-      V = e.V;
-      if(!_verify(abs(V)))
-              cout<<"-----"<<V<<endl;
-      VERIFY( abs(V) ,"V F_M ");
-
-
-      // interpolating currents speed
-      // !!check for earth.R scaling
-      vec3d W = siku.flows.get_at_lat_lon_rad ( Coordinates::norm_lat( lat ),
-                                                Coordinates::norm_lon( lon ) );
-      VERIFY( abs(W ),"1");
-      // transforming currents into local coords
-      W = Coordinates::glob_to_loc( e.q, W );
-      VERIFY( abs(W ),"2");
-
-      // velocity difference between ice element and water
-      W -= V;
-      VERIFY( abs(W ),"3");
-
-      // applying water forces
-      e.F += W * abs( W ) * e.A * siku.planet.R2 * wat_fact;
-      VERIFY( abs(W), "in f_m");
-      if(!_verify(abs(W))) cout<<"===="<<W<<endl;
-      VERIFY( e.F, string("water in forces mass ") + to_string(wat_fact)+
-              string("  ") + to_string(e.A) );
+      siku.es.F[i] += mass_force( siku, i );
     }
   
   // manual forces
   for( size_t i = 0; i < siku.man_inds.size(); ++i )
     {
       // indexes of manually added forces
-      size_t I = siku.man_inds[i];
+      size_t I = siku.slot[ siku.man_inds[i] ];
       vec3d tv;
 
-      double lat, lon;
-      sph_by_quat ( siku.es[I].q, &lat, &lon );
-
-      tv = glob_to_loc ( siku.es[I].q, geo_to_cart_surf_velo(
-          lat, lon, siku.man_forces[i].x, siku.man_forces[i].y ) );
+      tv = glob_to_loc ( siku.es[I].R, geo_to_cart_surf_velo(
+          siku.es[I].lat, siku.es[I].lon,
+          siku.man_forces[i].x, siku.man_forces[i].y ) );
 
       vec3d F = tv;
       double trq = siku.man_forces[i].z;
 
       // TODO: check planet.R scaling
       siku.es[I].flag |= Element::F_SPECIAL;
-      siku.es[I].F += F * siku.planet.R;
-      siku.es[I].N += trq;
+      siku.es.F[I] += F * siku.planet.R;
+      siku.es.N[I] += trq;
     }
 
 }
@@ -16,4 +16,8 @@
 //! \brief Update the forces by mass forces
 void forces_mass( Globals& siku );
 
+//! \brief Mass force (wind and water drag) acting on element at position
+//! 'i', N in local frame. Does not change the element
+vec3d mass_force( Globals& siku, size_t i );
+
 #endif      /* FORCES_MASS_HH */
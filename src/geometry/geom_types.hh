@@ -19,8 +19,17 @@
   // removing degrees support to avoid warning message
   #define GLM_FORCE_RADIANS
 
-  //TODO: DO implement this
-  //typedef double greal;
+  namespace Geometry
+  {
+    //! Scalar of narrow phase geometry kernels (polygons clipping). Positions
+    //! and quaternions are always kept in double. Mixed precision build
+    //! (--enable-mixed-precision) runs the kernels in float.
+    #ifdef SIKU_MIXED_PRECISION
+    typedef float greal;
+    #else
+    typedef double greal;
+    #endif
+  }
 
   //! Main quaternion types
   #include <glm/gtc/quaternion.hpp>
@@ -22,12 +22,389 @@ namespace Geometry
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~ external functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-  bool intersect_rourke( const cvpoly2d& P, const cvpoly2d& Q )
+  // point of clipping kernel with scalar of type T. Coordinates are taken
+  // relatively to the first vertex of first polygon, so they are small and
+  // float precision is enough
+  template<typename T>
+  struct _tp
   {
-    
-    
-    return false;
+    T x, y;
+
+    inline _tp operator + ( const _tp& b ) const { return { x + b.x, y + b.y }; }
+    inline _tp operator - ( const _tp& b ) const { return { x - b.x, y - b.y }; }
+    inline _tp operator * ( const T& s ) const { return { x * s, y * s }; }
+    inline bool operator == ( const _tp& b ) const
+    {
+      return x == b.x && y == b.y;
+    }
+  };
+
+  template<typename T>
+  inline static T _cross( const _tp<T>& a, const _tp<T>& b )
+  {
+    return a.x * b.y - a.y * b.x;
+  }
+
+  template<typename T>
+  inline static T _dot( const _tp<T>& a, const _tp<T>& b )
+  {
+    return a.x * b.x + a.y * b.y;
+  }
+
+  // point 'p' relatively to origin 'o' in kernel scalar and back
+  template<typename T>
+  inline static _tp<T> _to( const pnt2d& p, const pnt2d& o )
+  {
+    return { T( p.x - o.x ), T( p.y - o.y ) };
+  }
+  template<typename T>
+  inline static pnt2d _from( const _tp<T>& p, const pnt2d& o )
+  {
+    return { o.x + double( p.x ), o.y + double( p.y ) };
+  }
+
+  // sign of (b - a) x (c - a)
+  template<typename T>
+  inline static int _area_sign( const _tp<T>& a, const _tp<T>& b,
+                                const _tp<T>& c )
+  {
+    T d = _cross( b - a, c - a );
+    return ( d > T( 0 ) ) - ( d < T( 0 ) );
+  }
+
+  // if c lies on the segment ab (for collinear a, b, c)
+  template<typename T>
+  inline static bool _between( const _tp<T>& a, const _tp<T>& b,
+                               const _tp<T>& c )
+  {
+    if( a.x != b.x )
+      return ( a.x <= c.x && c.x <= b.x ) || ( a.x >= c.x && c.x >= b.x );
+    else
+      return ( a.y <= c.y && c.y <= b.y ) || ( a.y >= c.y && c.y >= b.y );
+  }
+
+  // intersection of segments ab and cd [O'Rourke, Computational Geometry
+  // in C, 7.7]. Returns: '0' - none, '1' - proper intersection, 'v' - an
+  // endpoint lies on other segment, 'e' - collinear overlapping segments.
+  // For 'e' p and q are the ends of the overlap.
+  template<typename T>
+  static char _seg_seg( const _tp<T>& a, const _tp<T>& b,
+                        const _tp<T>& c, const _tp<T>& d,
+                        _tp<T>& p, _tp<T>& q )
+  {
+    T denom = a.x * ( d.y - c.y ) + b.x * ( c.y - d.y )
+            + d.x * ( b.y - a.y ) + c.x * ( a.y - b.y );
+
+    if( denom == T( 0 ) )  // parallel segments
+      {
+        if( _area_sign( a, b, c ) != 0 ) return '0';
+
+        // collinear: collecting the ends of overlap
+        int k = 0;
+        _tp<T>* r[2] = { &p, &q };
+        if( _between( a, b, c ) )            *r[ k++ ] = c;
+        if( _between( a, b, d ) )            *r[ k++ ] = d;
+        if( k < 2 && _between( c, d, a ) )   *r[ k++ ] = a;
+        if( k < 2 && _between( c, d, b ) )   *r[ k++ ] = b;
+
+        return k ? 'e' : '0';
+      }
+
+    char code = '?';
+
+    T num = a.x * ( d.y - c.y ) + c.x * ( a.y - d.y )
+          + d.x * ( c.y - a.y );
+    if( num == T( 0 ) || num == denom ) code = 'v';
+    T s = num / denom;
+
+    num = -( a.x * ( c.y - b.y ) + b.x * ( a.y - c.y )
+             + c.x * ( b.y - a.y ) );
+    if( num == T( 0 ) || num == denom ) code = 'v';
+    T t = num / denom;
+
+    if( T( 0 ) < s && s < T( 1 ) && T( 0 ) < t && t < T( 1 ) )
+      code = '1';
+    else if( s < T( 0 ) || s > T( 1 ) || t < T( 0 ) || t > T( 1 ) )
+      code = '0';
+
+    p = a + ( b - a ) * s;
+    return code;
+  }
+
+  // adds a point to convex intersection skipping repeated neighbours. Polygon
+  // vertex status wins over edge intersection. Flags are optional
+  inline static void _add_cv_point( const pnt2d& p, PointStatus f,
+                                    vector<pnt2d>& v,
+                                    vector<PointStatus>* fl )
+  {
+    if( v.size() && v.back() == p )
+      {
+        if( fl && f == PointStatus::VERTEX ) fl->back() = f;
+        return;
+      }
+    v.push_back( p );
+    if( fl ) fl->push_back( f );
+  }
+
+  // if convex CCW polygon 'v' of 'n' vertices contains a point (inclusive)
+  inline static bool _contains( const pnt2d* v, size_t n, const pnt2d& p )
+  {
+    for( size_t i = 0; i < n; ++i )
+      if( cross( v[ ( i + 1 ) % n ] - v[i], p - v[i] ) < 0 )
+        return false;
+    return true;
+  }
+
+//---------------------------------------------------------------------
+
+  int intersect_rourke( const cvpoly2d& P, const cvpoly2d& Q,
+                        std::vector<pnt2d>& verts,
+                        std::vector<PointStatus>* pflags,
+                        pnt2d* pcen, double* psize )
+  {
+    return intersect_rourke( P.verts.data(), P.verts.size(),
+                             Q.verts.data(), Q.verts.size(),
+                             verts, pflags, pcen, psize );
+  }
+
+//---------------------------------------------------------------------
+
+  int intersect_rourke( const pnt2d* P, size_t n, const pnt2d* Q, size_t m,
+                        std::vector<pnt2d>& verts,
+                        std::vector<PointStatus>* pflags,
+                        pnt2d* pcen, double* psize )
+  {
+    return intersect_rourke_t<greal>( P, n, Q, m, verts, pflags, pcen,
+                                      psize );
+  }
+
+//---------------------------------------------------------------------
+
+  template<typename T>
+  int intersect_rourke_t( const pnt2d* P, size_t n, const pnt2d* Q, size_t m,
+                          std::vector<pnt2d>& verts,
+                          std::vector<PointStatus>* pflags,
+                          pnt2d* pcen, double* psize )
+  {
+    enum { Pin, Qin, Unknown } inflag = Unknown;
+
+    // results are built right in the output containers: no allocations
+    // while their capacity is enough
+    verts.clear();
+    if( pflags ) pflags->clear();
+
+    if( n < 3 || m < 3 ) return 0;
+
+    const pnt2d o = P[0];   // origin of kernel coordinates
+
+    size_t a = 0, b = 0;    // current edges: (a-1, a) and (b-1, b)
+    size_t aa = 0, ba = 0;  // amount of advances on P and Q
+    bool first = true;      // no intersections met yet
+    _tp<T> p, q;
+
+    // moves along the polygon (outputs passed vertex if it is inside)
+    auto advance = [&] ( const pnt2d* R, size_t& i, size_t& ia,
+                         size_t size, bool inside )
+      {
+        if( inside )
+          _add_cv_point( R[i], PointStatus::VERTEX, verts, pflags );
+        ++ia;
+        i = ( i + 1 ) % size;
+      };
+
+    do
+      {
+        const _tp<T> a0 = _to<T>( P[ ( a + n - 1 ) % n ], o ),
+                     a1 = _to<T>( P[a], o );
+        const _tp<T> b0 = _to<T>( Q[ ( b + m - 1 ) % m ], o ),
+                     b1 = _to<T>( Q[b], o );
+
+        // zero length edges (repeated vertices) are just skipped
+        if( a0 == a1 )
+          {
+            advance( P, a, aa, n, inflag == Pin );
+            continue;
+          }
+        if( b0 == b1 )
+          {
+            advance( Q, b, ba, m, inflag == Qin );
+            continue;
+          }
+
+        _tp<T> A = a1 - a0, B = b1 - b0;
+
+        T cr = _cross( A, B );
+        int c = ( cr > T( 0 ) ) - ( cr < T( 0 ) );
+        int aHB = _area_sign( b0, b1, a1 );  // a1 is in half-plane of B
+        int bHA = _area_sign( a0, a1, b1 );  // b1 is in half-plane of A
+
+        char code = _seg_seg( a0, a1, b0, b1, p, q );
+
+        if( code == '1' || code == 'v' )
+          {
+            if( inflag == Unknown && first )
+              {
+                aa = ba = 0;
+                first = false;
+              }
+            _add_cv_point( _from( p, o ), PointStatus::EDGE, verts, pflags );
+
+            if( aHB > 0 ) inflag = Pin;
+            else if( bHA > 0 ) inflag = Qin;
+          }
+
+        // edges overlap in opposite directions: touch along a segment
+        if( code == 'e' && _dot( A, B ) < T( 0 ) )
+          {
+            pnt2d dp = _from( p, o ), dq = _from( q, o );
+            if( pflags )
+              (*pflags) = { PointStatus::VERTEX, PointStatus::VERTEX };
+            if( psize )  *psize = ( dq - dp ).abs();
+            if( pcen )  *pcen = ( dp + dq ) / 2.;
+            return p == q ? 1 : 2;
+          }
+
+        // parallel and separated edges: no intersection
+        if( c == 0 && aHB < 0 && bHA < 0 ) return 0;
+
+        if( c == 0 && aHB == 0 && bHA == 0 )  // collinear
+          {
+            if( inflag == Pin )
+              advance( Q, b, ba, m, inflag == Qin );
+            else
+              advance( P, a, aa, n, inflag == Pin );
+          }
+        else if( c >= 0 )
+          {
+            if( bHA > 0 )
+              advance( P, a, aa, n, inflag == Pin );
+            else
+              advance( Q, b, ba, m, inflag == Qin );
+          }
+        else
+          {
+            if( aHB > 0 )
+              advance( Q, b, ba, m, inflag == Qin );
+            else
+              advance( P, a, aa, n, inflag == Pin );
+          }
+      }
+    while( ( aa < n || ba < m ) && aa < 2 * n && ba < 2 * m );
+
+    // closing polygon: the last point may repeat the first one
+    while( verts.size() > 1 && verts.back() == verts.front() )
+      {
+        verts.pop_back();
+        if( pflags )
+          {
+            if( pflags->back() == PointStatus::VERTEX )
+              pflags->front() = PointStatus::VERTEX;
+            pflags->pop_back();
+          }
+      }
+
+    // no boundaries crossing: one polygon is inside other, they are
+    // separated or just touch each other
+    if( inflag == Unknown )
+      {
+        const pnt2d* pin = nullptr;
+        size_t nin = 0;
+        if( _contains( Q, m, P[0] ) && _contains( Q, m, P[ n / 2 ] ) )
+          pin = P, nin = n;
+        else if( _contains( P, n, Q[0] ) && _contains( P, n, Q[ m / 2 ] ) )
+          pin = Q, nin = m;
+
+        if( pin )
+          {
+            verts.assign( pin, pin + nin );
+            if( pflags ) pflags->assign( nin, PointStatus::VERTEX );
+          }
+      }
+
+    // touching: the same points may be met several times
+    if( verts.size() <= 3 )
+      {
+        for( size_t i = 1; i < verts.size(); )
+          {
+            if( std::find( verts.begin(), verts.begin() + i, verts[i] )
+                != verts.begin() + i )
+              {
+                verts.erase( verts.begin() + i );
+                if( pflags ) pflags->erase( pflags->begin() + i );
+              }
+            else
+              ++i;
+          }
+      }
+
+    const size_t s = verts.size();
+
+    // no intersections
+    if( s == 0 ) return 0;
+
+    // single point touch
+    if( s == 1 )
+      {
+        if( pflags )  (*pflags) = { PointStatus::VERTEX };
+        if( psize )  *psize = 0.;
+        if( pcen )  *pcen = verts[ 0 ];
+        return 1;
+      }
+
+    // line intersection
+    if( s == 2 )
+      {
+        if( pflags )
+          (*pflags) = { PointStatus::VERTEX, PointStatus::VERTEX };
+        if( psize )  *psize = ( verts[ 1 ] - verts[ 0 ] ).abs();
+        if( pcen )  *pcen = ( verts[ 1 ] + verts[ 0 ] ) / 2.;
+        return 2;
+      }
+
+    // area and centroid (triangulation method, same as in 'intersect')
+    pnt2d v0 = verts[0];
+    vec2d tv1, tv2 = verts[1] - v0, tv3{};
+    double area = 0.;
+
+    for( size_t i = 2; i < s; ++i )
+      {
+        tv1 = tv2;
+        tv2 = verts[i] - v0;
+
+        double cr = cross( tv1, tv2 );
+        area += cr;
+        tv3 += ( tv1 + tv2 ) * cr / 6.;
+      }
+    area *= 0.5;
+
+    if( psize )  *psize = area;
+    if( pcen )
+      {
+        if( area == 0. )  // spiky solution (see 'intersect')
+          {
+            *pcen = {};
+            for( auto& v : verts )
+              *pcen += v;
+            *pcen /= s;
+          }
+        else
+          *pcen = v0 + tv3 / area;
+      }
+
+    return s;
   }
+
+  // kernels of both precisions are always available (for validation)
+  template int intersect_rourke_t<float>( const pnt2d*, size_t,
+                                          const pnt2d*, size_t,
+                                          std::vector<pnt2d>&,
+                                          std::vector<PointStatus>*,
+                                          pnt2d*, double* );
+  template int intersect_rourke_t<double>( const pnt2d*, size_t,
+                                           const pnt2d*, size_t,
+                                           std::vector<pnt2d>&,
+                                           std::vector<PointStatus>*,
+                                           pnt2d*, double* );
   
 //---------------------------------------------------------------------
   
@@ -211,8 +588,10 @@ namespace Geometry
       int n = P.size(), k = 0;
       vector<vec2d> H( 2*n );
 
-      // Sort points lexicographically
-      sort( P.begin(), P.end() );
+      // Sort points lexicographically (explicit comparator: global operator<
+      // is not visible from std::sort and vec2d converts to bool)
+      sort( P.begin(), P.end(), [] ( const vec2d& a, const vec2d& b )
+            { return a.x < b.x || ( a.x == b.x && a.y < b.y ); } );
 
       // Build lower hull
       for ( int i = 0; i < n; ++i )
@@ -84,6 +84,32 @@ namespace Geometry
                   std::vector<PointStatus>* flags = nullptr,
                   pnt2d* center = nullptr, double* size = nullptr );
 
+  //! \brief calculates intersection of two convex CCW oriented polygons in
+  //! O(n+m) time (O'Rourke`s method). Parameters and results are the same as
+  //! for 'intersect', but 'verts' and 'flags' are given in CCW order.
+  int intersect_rourke( const cvpoly2d& poly1, const cvpoly2d& poly2,
+                        std::vector<pnt2d>& verts,
+                        std::vector<PointStatus>* flags = nullptr,
+                        pnt2d* center = nullptr, double* size = nullptr );
+
+  //! \brief same as above for raw arrays of vertices. Results are written
+  //! directly to 'verts' and 'flags', so there are no heap allocations if
+  //! their capacity is enough.
+  //! Clipping is done with 'greal' scalar (see geom_types.hh).
+  int intersect_rourke( const pnt2d* P, size_t n, const pnt2d* Q, size_t m,
+                        std::vector<pnt2d>& verts,
+                        std::vector<PointStatus>* flags = nullptr,
+                        pnt2d* center = nullptr, double* size = nullptr );
+
+  //! \brief same as above with clipping kernel scalar 'T' given explicitly.
+  //! Instantiated for float and double. Input and output are in double,
+  //! area and centroid are calculated in double.
+  template<typename T>
+  int intersect_rourke_t( const pnt2d* P, size_t n, const pnt2d* Q, size_t m,
+                          std::vector<pnt2d>& verts,
+                          std::vector<PointStatus>* flags = nullptr,
+                          pnt2d* center = nullptr, double* size = nullptr );
+
   /* source:
 https://en.wikibooks.org/wiki/Algorithm_Implementation/Geometry/Convex_hull/Monotone_chain
   */
@@ -96,6 +122,9 @@ https://en.wikibooks.org/wiki/Algorithm_Implementation/Geometry/Convex_hull/Mono
     friend int intersect( const cvpoly2d&, const cvpoly2d&,
                           std::vector<pnt2d>&, std::vector<PointStatus>*,
                           pnt2d*, double* );
+    friend int intersect_rourke( const cvpoly2d&, const cvpoly2d&,
+                                 std::vector<pnt2d>&,
+                                 std::vector<PointStatus>*, pnt2d*, double* );
   protected:
     std::vector<pnt2d> verts;
 
@@ -0,0 +1,146 @@
+/*
+ * quat_batch.cc
+ *
+ * Batched quaternion and rotation kernels. Loops are plain element-wise
+ * arithmetic without branches, so the compiler vectorizes them; each
+ * kernel is compiled for AVX-512, AVX2 and generic x86-64 and the best
+ * one is chosen at load time (GCC function multiversioning).
+ */
+
+#include <cmath>
+
+#include "quat_batch.hh"
+
+// runtime dispatch between instruction sets: only with GCC on x86-64 ELF
+// (ifunc), other builds get the single version for $(SIMD_FLAGS)
+#if defined( __GNUC__ ) && !defined( __clang__ ) \
+    && defined( __x86_64__ ) && defined( __ELF__ )
+#define SIMD_CLONES __attribute__(( target_clones( "avx512f", "avx2", \
+                                                   "default" ) ))
+#else
+#define SIMD_CLONES
+#endif
+
+namespace Geometry
+{
+
+  SIMD_CLONES
+  void quats_mul( const quat* a, const quat* b, quat* r, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double aw = a[i].w, ax = a[i].x, ay = a[i].y, az = a[i].z;
+        const double bw = b[i].w, bx = b[i].x, by = b[i].y, bz = b[i].z;
+
+        r[i].w = aw * bw - ax * bx - ay * by - az * bz;
+        r[i].x = aw * bx + ax * bw + ay * bz - az * by;
+        r[i].y = aw * by + ay * bw + az * bx - ax * bz;
+        r[i].z = aw * bz + az * bw + ax * by - ay * bx;
+      }
+  }
+
+  // --------------------------------------------------------------------------
+
+  SIMD_CLONES
+  void quats_cmul( const quat* a, const quat* b, quat* r, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double aw = a[i].w, ax = -a[i].x, ay = -a[i].y, az = -a[i].z;
+        const double bw = b[i].w, bx = b[i].x, by = b[i].y, bz = b[i].z;
+
+        r[i].w = aw * bw - ax * bx - ay * by - az * bz;
+        r[i].x = aw * bx + ax * bw + ay * bz - az * by;
+        r[i].y = aw * by + ay * bw + az * bx - ax * bz;
+        r[i].z = aw * bz + az * bw + ax * by - ay * bx;
+      }
+  }
+
+  // --------------------------------------------------------------------------
+
+  SIMD_CLONES
+  void quats_normalize( quat* q, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double l2 = q[i].w * q[i].w + q[i].x * q[i].x
+                        + q[i].y * q[i].y + q[i].z * q[i].z;
+
+        // degenerate quaternion turns to identity (as in glm::normalize)
+        const bool ok = l2 > 0.;
+        const double s = ok ? 1. / std::sqrt( l2 ) : 0.;
+
+        q[i].w = ok ? q[i].w * s : 1.;
+        q[i].x *= s;
+        q[i].y *= s;
+        q[i].z *= s;
+      }
+  }
+
+  // --------------------------------------------------------------------------
+
+  SIMD_CLONES
+  void quats_rotate( const quat* q, const vec3d* v, vec3d* r, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double w = q[i].w, x = q[i].x, y = q[i].y, z = q[i].z;
+        const double vx = v[i].x, vy = v[i].y, vz = v[i].z;
+
+        // rows of mat3_cast( q )
+        r[i].x = ( 1. - 2. * ( y * y + z * z ) ) * vx
+               + 2. * ( x * y - w * z ) * vy
+               + 2. * ( x * z + w * y ) * vz;
+        r[i].y = 2. * ( x * y + w * z ) * vx
+               + ( 1. - 2. * ( x * x + z * z ) ) * vy
+               + 2. * ( y * z - w * x ) * vz;
+        r[i].z = 2. * ( x * z - w * y ) * vx
+               + 2. * ( y * z + w * x ) * vy
+               + ( 1. - 2. * ( x * x + y * y ) ) * vz;
+      }
+  }
+
+  // --------------------------------------------------------------------------
+
+  SIMD_CLONES
+  void quats_to_m3( const quat* q, mat3d* R, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double w = q[i].w, x = q[i].x, y = q[i].y, z = q[i].z;
+
+        // columns, as in glm::mat3_cast
+        R[i][0][0] = 1. - 2. * ( y * y + z * z );
+        R[i][0][1] = 2. * ( x * y + w * z );
+        R[i][0][2] = 2. * ( x * z - w * y );
+
+        R[i][1][0] = 2. * ( x * y - w * z );
+        R[i][1][1] = 1. - 2. * ( x * x + z * z );
+        R[i][1][2] = 2. * ( y * z + w * x );
+
+        R[i][2][0] = 2. * ( x * z + w * y );
+        R[i][2][1] = 2. * ( y * z - w * x );
+        R[i][2][2] = 1. - 2. * ( x * x + y * y );
+      }
+  }
+
+  // --------------------------------------------------------------------------
+
+  SIMD_CLONES
+  void quats_lat_lon( const quat* q, double* lat, double* lon, size_t n )
+  {
+    for( size_t i = 0; i < n; ++i )
+      {
+        const double w = q[i].w, x = q[i].x, y = q[i].y, z = q[i].z;
+
+        // image of the north pole: last column of mat3_cast( q )
+        const double gx = 2. * ( x * z + w * y ),
+                     gy = 2. * ( y * z - w * x ),
+                     gz = 1. - 2. * ( x * x + y * y );
+
+        lat[i] = M_PI / 2. - std::atan2( std::sqrt( gx * gx + gy * gy ), gz );
+        lon[i] = std::atan2( gy, gx );
+      }
+  }
+
+}
@@ -0,0 +1,42 @@
+/*
+ * quat_batch.hh
+ *
+ * Batched quaternion and rotation kernels: the same operation over arrays
+ * of quaternions and vectors. Built for several instruction sets (AVX-512,
+ * AVX2, generic) with runtime dispatch where the compiler supports it.
+ */
+
+#ifndef QUAT_BATCH_HH_
+#define QUAT_BATCH_HH_
+
+#include <cstddef>
+
+#include "matrix3d.hh"
+// #include chain:
+// gtypes -- vec3d - pnt3d - mat3d - quat_batch
+
+namespace Geometry
+{
+  //! \brief r[i] = a[i] * b[i] (Hamilton product, same as glm::cross)
+  void quats_mul( const quat* a, const quat* b, quat* r, size_t n );
+
+  //! \brief r[i] = conjugate( a[i] ) * b[i]: relative rotation from 'a' frame
+  //! to 'b' frame (see Coordinates::loc_to_loc_mat)
+  void quats_cmul( const quat* a, const quat* b, quat* r, size_t n );
+
+  //! \brief normalizes quaternions in place
+  void quats_normalize( quat* q, size_t n );
+
+  //! \brief r[i] = mat3_cast( q[i] ) * v[i] (rotation of vectors by unit
+  //! quaternions). 'r' may be the same array as 'v'
+  void quats_rotate( const quat* q, const vec3d* v, vec3d* r, size_t n );
+
+  //! \brief R[i] = mat3_cast( q[i] ) (rotation matrixes of unit quaternions)
+  void quats_to_m3( const quat* q, mat3d* R, size_t n );
+
+  //! \brief latitudes and longitudes (radians, not normalized) of points
+  //! where unit quaternions move the north pole (see Coordinates::sph_by_quat)
+  void quats_lat_lon( const quat* q, double* lat, double* lon, size_t n );
+}
+
+#endif /* QUAT_BATCH_HH_ */
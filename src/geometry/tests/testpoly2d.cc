@@ -76,6 +76,30 @@ void poly_inter_test( const cvpoly2d& p1, const cvpoly2d& p2,
     }
   cout<<"edge p: "<<ei<<",  vert p: "<<vi<<endl;
 
+  cout<<"rourke: n = " << intersect_rourke(p1, p2, res, &ps, &cen, &size);
+  cout<<", s = "<< size <<", c = ";
+  print( cen );
+  cout << endl;
+
+  vi = 0, ei = 0;
+  for(auto& a : ps)
+    {
+      if(a == PointStatus::VERTEX) vi++;
+      if(a == PointStatus::EDGE) ei++;
+    }
+  cout<<"edge p: "<<ei<<",  vert p: "<<vi<<endl;
+
+  // float kernel (used in mixed precision build)
+  cout<<"rourke (float): n = "
+      << intersect_rourke_t<float>( p1.vertices().data(),
+                                    p1.vertices().size(),
+                                    p2.vertices().data(),
+                                    p2.vertices().size(),
+                                    res, nullptr, &cen, &size );
+  cout<<", s = "<< size <<", c = ";
+  print( cen );
+  cout << endl;
+
   cout << "=== Rourke's test: === " << endl;
   cvpoly2d X;
   bool is_intersect = X.intersect( P, Q );
@@ -0,0 +1,95 @@
+/*!
+
+  \file testquatbatch.cc
+
+  \brief Simple test for batched quaternion kernels: results are compared
+  with scalar glm ones
+
+*/
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+#include "quat_batch.hh"
+using namespace Geometry;
+
+// maximal absolute difference of components
+double diff( const quat& a, const quat& b )
+{
+  return max( max( fabs( a.w - b.w ), fabs( a.x - b.x ) ),
+              max( fabs( a.y - b.y ), fabs( a.z - b.z ) ) );
+}
+
+double diff( const vec3d& a, const vec3d& b )
+{
+  return max( max( fabs( a.x - b.x ), fabs( a.y - b.y ) ), fabs( a.z - b.z ) );
+}
+
+int main()
+{
+  cout << "--------- Test for batched quaternion kernels -----------" << endl;
+
+  const size_t S = 37;          // not a multiple of any vector width
+  quat a[ S ], b[ S ], r[ S ];
+  vec3d v[ S ], u[ S ];
+  mat3d R[ S ];
+  double lat[ S ], lon[ S ];
+
+  for ( size_t i = 0; i < S; ++i )
+    {
+      a[i] = glm::normalize( quat( 1. + i, 0.1 * i, -0.3 * i, 0.7 ) );
+      b[i] = glm::normalize( quat( 0.5, -0.2 * i, 1., 0.05 * i * i ) );
+      v[i] = vec3d( 1. * i, 2. - i, 0.5 );
+    }
+
+  double e = 0.;
+  quats_mul( a, b, r, S );
+  for ( size_t i = 0; i < S; ++i )
+    e = max( e, diff( r[i], glm::cross( a[i], b[i] ) ) );
+  cout << "\nquats_mul, max error, correct: ~1e-16:\n" << e << endl;
+
+  e = 0.;
+  quats_cmul( a, b, r, S );
+  for ( size_t i = 0; i < S; ++i )
+    e = max( e, diff( r[i], glm::cross( glm::conjugate( a[i] ), b[i] ) ) );
+  cout << "\nquats_cmul, max error, correct: ~1e-16:\n" << e << endl;
+
+  e = 0.;
+  for ( size_t i = 0; i < S; ++i ) r[i] = a[i] * ( 3. + i );
+  quats_normalize( r, S );
+  for ( size_t i = 0; i < S; ++i )
+    e = max( e, diff( r[i], a[i] ) );
+  cout << "\nquats_normalize, max error, correct: ~1e-16:\n" << e << endl;
+
+  r[0] = quat( 0., 0., 0., 0. );
+  quats_normalize( r, 1 );
+  cout << "\nnormalized zero quaternion, correct: 1 0 0 0:\n" << r[0] << endl;
+
+  e = 0.;
+  quats_rotate( a, v, u, S );
+  for ( size_t i = 0; i < S; ++i )
+    e = max( e, diff( u[i], glm::mat3_cast( a[i] ) * v[i] ) );
+  cout << "\nquats_rotate, max error, correct: ~1e-15:\n" << e << endl;
+
+  e = 0.;
+  quats_to_m3( a, R, S );
+  for ( size_t i = 0; i < S; ++i )
+    for ( int k = 0; k < 3; ++k )
+      e = max( e, diff( R[i][k], glm::mat3_cast( a[i] )[k] ) );
+  cout << "\nquats_to_m3, max error, correct: ~1e-16:\n" << e << endl;
+
+  e = 0.;
+  quats_lat_lon( a, lat, lon, S );
+  for ( size_t i = 0; i < S; ++i )
+    {
+      vec3d g = glm::mat3_cast( a[i] ) * vec3d( 0., 0., 1. );
+      e = max( e, fabs( lat[i] - ( M_PI / 2. - atan2( sqrt( g.x * g.x
+                                                    + g.y * g.y ), g.z ) ) ) );
+      e = max( e, fabs( lon[i] - atan2( g.y, g.x ) ) );
+    }
+  cout << "\nquats_lat_lon, max error, correct: ~1e-15:\n" << e << endl;
+
+  return 0;
+}
@@ -9,6 +9,7 @@
 #include "globals.hh"
 #include "sikupy.hh"
 #include "coordinates.hh"
+#include "errors.hh"
 
 #include "fstream"
 
@@ -27,34 +28,55 @@ Globals::Globals()
 
 void Globals::post_init()
 {
+  resolve_consts();
+
   wind.init( wind.FIELD_SOURCE_TYPE );
 //  if( wind.FIELD_SOURCE_TYPE == Vecfield::NMC )
 //    Sikupy::read_nmc_vecfield ( *siku.wind.NMCVec, "wind" );
 
+  slot.resize( es.size() );
+
+  // islands are not saved: everything starts awake
+  sleep_next_island = 0;
+  sleep_count = 0;
+  sleep_forcing_seen = forcing_changes;
+
   for( size_t i =0; i < es.size(); ++i )
     {
       // setting new elements id
       es[i].id = i;
+      slot[i] = i;
+
+      // initial orientation cache (then it is refreshed by 'position')
+      es[i].update_orient( es.q[i] );
+
+      // islands are not saved: everything starts awake
+      es[i].flag &= ~Element::F_SLEEPING;
+
+      // loaded or new elements: mass properties are computed from scratch
+      es[i].flag |= Element::F_MASS_DIRTY;
+
+      // local 2d frame and simplified collision polygon
+      es[i].update_frame();
+      if( proxy_verts )
+        es[i].build_proxy( proxy_verts, proxy_err );
 
       vec3d temp;
 
       if( ! (es[i].flag & Element::F_PROCESSED) )  //only for new elements
         {
-          // setting default (loaded from .py) velocity and rotation
-          double lat, lon;
-          sph_by_quat ( es[i].q, &lat, &lon );
-
           // for new elements velocity must be inputed in East-North terms
-          temp = glob_to_loc ( es[i].q, geo_to_cart_surf_velo(
-              lat, lon, es[i].V.x, es[i].V.y ) );
+          // (setting default (loaded from .py) velocity and rotation)
+          temp = glob_to_loc ( es[i].R, geo_to_cart_surf_velo(
+              es[i].lat, es[i].lon, es.V[i].x, es.V[i].y ) );
         }
       else
         {
-          temp = es[i].V;
+          temp = es.V[i];
         }
 
-      es[i].W = vec3d( -temp.y * planet.R_rec, temp.x * planet.R_rec,
-                       es[i].V.z );
+      es.W[i] = vec3d( -temp.y * planet.R_rec, temp.x * planet.R_rec,
+                       es.V[i].z );
 
     }
 
@@ -137,3 +159,62 @@ void Globals::add_contr( std::string& con, Element& e )
    */
 }
 
+// --------------------------------------------------------------------------
+
+void Globals::mass_changed()
+{
+  for( auto& e : es )
+    e.flag |= Element::F_MASS_DIRTY;
+}
+
+// --------------------------------------------------------------------------
+
+void Globals::resolve_consts()
+{
+  // names of constants in python and their places in resolved table
+  static const struct
+  {
+    const char* name;
+    double PhysConsts::* field;
+  } table[] =
+  {
+    { "rigidity", &PhysConsts::rigidity },
+    { "viscosity", &PhysConsts::viscosity },
+    { "rotatability", &PhysConsts::rotatability },
+    { "tangency", &PhysConsts::tangency },
+    { "elasticity", &PhysConsts::elasticity },
+    { "bendability", &PhysConsts::bendability },
+    { "solidity", &PhysConsts::solidity },
+    { "tensility", &PhysConsts::tensility },
+    { "windage", &PhysConsts::windage },
+    { "anchority", &PhysConsts::anchority },
+    { "fastency", &PhysConsts::fastency },
+    { "sigma", &PhysConsts::sigma },
+    { "etha", &PhysConsts::etha }
+  };
+
+  PhysConsts t;
+
+  for( auto& c : table )
+    {
+      auto it = phys_consts.find( c.name );
+      if( it != phys_consts.end() )
+        t.*c.field = it->second;
+      else
+        warning( "physical constant '%s' is not set, 0 is used", c.name );
+    }
+
+  // probably misspelled names
+  for( auto& p : phys_consts )
+    {
+      bool known = false;
+      for( auto& c : table )
+        known |= p.first == c.name;
+
+      if( !known )
+        warning( "unknown physical constant '%s' is ignored",
+                 p.first.c_str() );
+    }
+
+  pc = t;
+}
@@ -29,9 +29,34 @@ enum : unsigned long
   STATUS_SAVE = 0x1,
   STATUS_WINDS = 0x2,
   STATUS_CURRENTS = 0x4,
+  STATUS_PHYS_CONSTS = 0x8,  // physical constants were changed in python
+  STATUS_MATERIALS = 0x10,  // materials were changed in python
   STATUS_EXIT = 0x80 // aka 128
 };
 
+//! \brief physical constants resolved from 'Globals::phys_consts' map by
+//! 'Globals::resolve_consts'. Kernels use these fields instead of looking up
+//! strings in the map.
+struct alignas( 64 ) PhysConsts
+{
+  double rigidity { 0. };       //!< 'bouncing' on impact
+  double viscosity { 0. };      //!< 'sticking' on impact
+  double rotatability { 0. };   //!< part of force applied to rotation
+  double tangency { 0. };       //!< part of force applied to sliding
+
+  double elasticity { 0. };     //!< hardness of spring in joints
+  double bendability { 0. };    //!< part of spring force applied to rotation
+  double solidity { 0. };       //!< part of extension applied to damage
+  double tensility { 0. };      //!< extension-without-damage cap
+
+  double windage { 0. };        //!< part of wind applied to force
+  double anchority { 0. };      //!< generic viscosity of water
+  double fastency { 0. };       //!< overlap with landfast to become landfast
+
+  double sigma { 0. };          //!< rigidity of collisions
+  double etha { 0. };           //!< viscosity of collisions
+};
+
 enum CONTACT_FORCE_MODEL : unsigned long
 {
   CF_DEFAULT = 0,
@@ -56,10 +81,13 @@ struct Globals
 
   Material tmat;
 
-  //! Elements data !! Important: the order of elements in this array should
-  //! remain unchanged. Element IDs match their position in this vector.
-  //! For any sorting necessities use 'pes' vector.
-  std::vector < Element > es;
+  //! Elements data. Elements may be reordered in this array (see
+  //! 'reorder'), so use 'slot' to find an element by its ID. Contacts keep
+  //! positions in this array, while output and python use IDs.
+  ElementStore es;
+
+  //! Position of element in 'es' by its ID: es[ slot[id] ].id == id
+  std::vector < size_t > slot;
 
   //! Elements` pointers vector for sortings and temporal processings
   std::vector < Element* > pes;
@@ -78,10 +106,13 @@ struct Globals
   std::vector < std::string > wind_crs;
 
   // IMPROVE: reconsider this mechanism
-  //! physical constants
+  //! physical constants (as loaded from python)
   //std::vector <double> phys_consts;
   std::map <std::string, double> phys_consts;
 
+  //! physical constants resolved from 'phys_consts' (for hot loops)
+  PhysConsts pc;
+
   //! model time 
   ModelTime time;
 
@@ -117,11 +148,61 @@ struct Globals
   //! contact force model
   CONTACT_FORCE_MODEL cont_force_model { CF_DEFAULT };
 
+  //! deterministic summation of contact forces: results do not depend on
+  //! amount of threads (slightly slower). 0 - off
+  unsigned long cont_det_sum { 0 };
+
+  //! fused multithreaded integration pass ('integrate'). 0 - separate
+  //! 'dynamics', 'position' and 'mproperties' passes (reference path)
+  unsigned long fused_integr { 1 };
+
+  //! period (in steps) of spatial reordering of elements. 0 - never
+  unsigned long reorder_period { 0 };
+
+  //! maximal amount of vertices of simplified collision polygons (proxies).
+  //! 0 - exact polygons are used for collisions and fastening
+  unsigned long proxy_verts { 0 };
+
+  //! maximal error of collision proxy (relative to element size)
+  double proxy_err { 0.05 };
+
+  //! amount of steps an island of connected elements must stay calm to
+  //! fall asleep. 0 - sleeping is off
+  unsigned long sleep_steps { 0 };
+
+  //! sleeping thresholds: local speed (m/s), spin (1/s) and acceleration
+  //! by net force (m/s^2). The last one is also the tolerance of mass
+  //! force change that wakes sleeping elements
+  double sleep_velo { 1e-3 };
+  double sleep_spin { 1e-5 };
+  double sleep_accel { 1e-5 };
+
+  //! counter of external forcing changes (wind updates, physical constants
+  //! refresh). Sleeping elements recheck their mass forces when it grows
+  unsigned long forcing_changes { 0 };
+
+  //! sleeping state (see 'sleeping'): id of last sleeping island, amount of
+  //! sleeping elements and forcing changes already checked by sleepers.
+  //! Reset together with F_SLEEPING flags
+  size_t sleep_next_island { 0 };
+  size_t sleep_count { 0 };
+  unsigned long sleep_forcing_seen { 0 };
+
   // ------------------------------ METHODS ---------------------------------
 
   //! Post-initialization (with loaded values)
   void post_init();
 
+  //! Resolves 'phys_consts' map into 'pc'. Missing and unknown constants
+  //! are reported (missing ones are set to 0). Called in 'post_init' and
+  //! each time python sets STATUS_PHYS_CONSTS.
+  void resolve_consts();
+
+  //! Marks mass properties of all elements for recomputation (see
+  //! Element::F_MASS_DIRTY). Called after materials change; code changing
+  //! 'gh', 'imat' or 'A' of single elements sets the flag itself.
+  void mass_changed();
+
   //! Default constructor
   Globals();
 
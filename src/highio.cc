@@ -69,10 +69,10 @@ int Highio::save( const Globals& siku )
   lowio.save_astrings( siku.cons, string( "Control functions" ),
                        string( "TODO: fill" ) );
 
-  // saving polygon vertices
-  presave_verts( siku );
+  // saving polygon vertices (the pool is kept in the order of IDs)
   lowio.save_array( lowio.type_vert(), "Elements/Vertices",
-                      verts.data(), verts.size(), "TODO: fill", "TODO: fill" );
+                    siku.es.verts.data(), siku.es.verts.size(),
+                    "TODO: fill", "TODO: fill" );
 
   // saving flags and names
   lowio.save_string( string("Border File"), siku.bord_file,  "TODO: fill",
@@ -102,51 +102,39 @@ int Highio::save( const Globals& siku )
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-void Highio::presave_verts( const Globals& siku )
-{
-  verts.clear();
-
-  for( auto& e : siku.es )
-    {
-      for( auto& v : e.P )
-        {
-          verts.push_back( Element::vertex( v, e.id ) );
-        }
-    }
-}
-
-//---------------------------------------------------------------------
-
 void Highio::save_elements( const Globals& siku )
 {
   PlainElement* El = new PlainElement[siku.es.size()];
   for(unsigned long i=0;i<siku.es.size();i++)
     {
-      El[i].flag = siku.es[i].flag;
-      El[i].mon_ind = siku.es[i].mon_ind;
-      El[i].con_ind = siku.es[i].con_ind;
-      El[i].id = siku.es[i].id;
+      // in the order of IDs
+      auto r = siku.es.ref( siku.slot[i] );
+      const Element& e = r.e;
+      El[i].flag = e.flag;
+      El[i].mon_ind = e.mon_ind;
+      El[i].con_ind = e.con_ind;
+      El[i].id = e.id;
       // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      El[i].q = siku.es[i].q;
-      El[i].Glob = siku.es[i].Glob;
+      El[i].q = r.q;
+      El[i].Glob = e.Glob;
 
-      El[i].V = siku.es[i].V; // TODO: shouldnt velo be saved in global coords?
+      El[i].V = r.V; // TODO: shouldnt velo be saved in global coords?
 
-      El[i].m = siku.es[i].m;
-      El[i].I = siku.es[i].I;
-      El[i].W = siku.es[i].W;
-      El[i].F = siku.es[i].F;
-      El[i].N = siku.es[i].N;
+      El[i].m = r.m;
+      El[i].I = r.I;
+      El[i].W = r.W;
+      El[i].F = r.F;
+      El[i].N = r.N;
       // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-      El[i].imat = siku.es[i].imat;
-      El[i].igroup = siku.es[i].igroup;
-      El[i].i = siku.es[i].i;
-      El[i].A = siku.es[i].A;
-      El[i].sbb_rmin = siku.es[i].sbb_rmin;
+      El[i].imat = e.imat;
+      El[i].igroup = e.igroup;
+      El[i].i = e.i;
+      El[i].A = e.A;
+      El[i].sbb_rmin = e.sbb_rmin;
       // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
       for( unsigned int j = 0; j < MAT_LAY_AMO; ++j )
         {
-          El[i].gh[j] = siku.es[i].gh[j];
+          El[i].gh[j] = e.gh[j];
         }
     }
 //  lowio.save_array( lowio.type_element(), "Elements/Elements",
@@ -251,9 +239,18 @@ void Highio::save_condet( const Globals& siku )
 
   if( siku.ConDet.cont.size() )
     {
+      // contacts are saved with elements` IDs instead of positions
+      std::vector<ContactDetector::Contact> cs( siku.ConDet.cont.begin(),
+                                                siku.ConDet.cont.end() );
+      for( auto& c : cs )
+        {
+          c.i1 = siku.es[ c.i1 ].id;
+          c.i2 = siku.es[ c.i2 ].id;
+        }
+
       lowio.save_array ( lowio.stdtypes.t_contact,
                          string ( "Contacts/Contacts" ),
-                         siku.ConDet.cont.data (), siku.ConDet.cont.size (),
+                         cs.data (), cs.size (),
                          "TODO: fill", "TODO: fill" );
     }
   else
@@ -485,19 +482,21 @@ int Highio::load_elements( Globals& siku, const string& filename )
   lowio.read( "Elements/Elements", El );
   for( unsigned long i=0; i < siku.es.size(); i++ )
     {
+      auto r = siku.es.ref( i );
+
       siku.es[i].flag = El[i].flag;
       siku.es[i].mon_ind = El[i].mon_ind;
       siku.es[i].con_ind = El[i].con_ind;
       siku.es[i].id = El[i].id;
 
-      siku.es[i].q = El[i].q;
+      r.q = El[i].q;
       siku.es[i].Glob = El[i].Glob;
-      siku.es[i].V = El[i].V;
-      siku.es[i].m = El[i].m;
-      siku.es[i].I = El[i].I;
-      siku.es[i].W = El[i].W;
-      siku.es[i].F = El[i].F;
-      siku.es[i].N = El[i].N;
+      r.V = El[i].V;
+      r.m = El[i].m;
+      r.I = El[i].I;
+      r.W = El[i].W;
+      r.F = El[i].F;
+      r.N = El[i].N;
 
       siku.es[i].imat = El[i].imat;
       siku.es[i].igroup = El[i].igroup;
@@ -509,21 +508,13 @@ int Highio::load_elements( Globals& siku, const string& filename )
         {
           siku.es[i].gh[j] = El[i].gh[j];
         }
-
-      siku.es[i].P.clear();
     }
   delete[] El;
 
-  // verts
-  verts.resize( dims.vert_s );
-  lowio.read( "Elements/Vertices", verts.data() );
-
-  for( unsigned long i=0; i < verts.size(); i++ )
-    {
-      unsigned long ind = verts[i].elem_id;
-      vec3d pos = verts[i].pos;
-      siku.es[ ind ].P.push_back( pos );
-    }
+  // verts: IDs of loaded elements are their positions
+  siku.es.verts.resize( dims.vert_s );
+  lowio.read( "Elements/Vertices", siku.es.verts.data() );
+  siku.es.bind_verts();
 
   lowio.release();
 
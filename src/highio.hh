@@ -28,11 +28,6 @@ public:
   };
 
   // ---------------------------------------------------------------------
-private:
-
-  // vector of polygon vertices for saving and loading
-  vector<Element::vertex> verts;
-
 public:
 
   static const int STATUS_OK       { 0x0 }; //!< OK status code
@@ -62,11 +57,6 @@ private:
   //! \brief main object for high I/O put here to avoid extra type registrations
   Lowio lowio;
 
-  //! \brief fill vertices vector with polygon vertices` coordinates for saving
-  //! !!IMPORTANT: works with local coordinates
-  //! \param[in] siku global variables
-  void presave_verts( const Globals& siku );
-
   //! save globals.elements
   void save_elements( const Globals& siku );
 
@@ -0,0 +1,38 @@
+/*!
+
+ \file integrate.cc
+
+ \brief Implementation of fused integration pass
+
+ */
+
+#include <algorithm>
+
+#include "integrate.hh"
+#include "dynamics.hh"
+#include "position.hh"
+#include "mproperties.hh"
+
+void
+integrate ( Globals& siku, const double dt )
+{
+  const long n = siku.es.size();
+  const long B = POSITION_BLOCK;
+
+  // elements are independent here: each thread streams its own chunks of
+  // element arrays once instead of three times. A chunk stays in cache
+  // between the stages
+#pragma omp parallel for schedule(static)
+  for ( long b = 0; b < n; b += B )
+    {
+      const long e = std::min( n, b + B );
+
+      for ( long i = b; i < e; ++i )
+        dynamics_element ( siku, i, dt );
+
+      position_block ( siku, b, e, dt );
+
+      for ( long i = b; i < e; ++i )
+        mproperties_element ( siku, i );
+    }
+}
@@ -0,0 +1,25 @@
+/*!
+
+ \file integrate.hh
+
+ \brief Fused integration pass: dynamics, position and properties update
+ of each element in one multithreaded traversal
+
+ */
+
+#ifndef INTEGRATE_HH
+#define INTEGRATE_HH
+
+#include "globals.hh"
+
+//! \brief Updates velocities, orientations and mechanical properties of all
+//! elements in a single parallel pass over elements: per element it is the
+//! same as 'dynamics', 'position' and 'mproperties' called one after another
+//! (those remain the reference path, see 'siku.fused_integr'), positions are
+//! updated by batched quaternion kernels ('position_block'). Accumulated
+//! forces are kept: they are still read by sleeping, monitors and output and
+//! are cleaned by 'clean_props'.
+void
+integrate ( Globals& siku, const double dt );
+
+#endif      /* INTEGRATE_HH */
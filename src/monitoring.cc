@@ -15,7 +15,8 @@ void monitoring( Globals& siku, Sikupy& sikupy )
 {
   // Monitoring the elements
 
-  for ( size_t i = 0; i < siku.es.size(); ++i )
+  // in the order of IDs
+  for ( auto i : siku.slot )
     {
     if ( siku.es[i].flag & Element::F_MONITORED )
       {
@@ -7,6 +7,7 @@
 */
 
 #include <assert.h>
+#include <algorithm>
 
 #include "mproperties.hh"
 #include "errors.hh"
@@ -15,6 +16,135 @@
 
 using namespace Geometry;
 
+// ----------------------------- local utils --------------------------------
+
+// mass, moment of inertia and their inverses used by 'dynamics'
+inline void _mass_props( Globals& siku, const size_t k )
+{
+  auto& es = siku.es;
+  Element& e = es[k];
+
+  Material *pmat = &siku.ms[ e.imat ]; // short link to material
+
+  // mass update
+  double m = 0.;
+  for ( size_t i = 0; i < MAT_LAY_AMO; ++i )
+    {
+      m += pmat->layers[i].thickness * pmat->layers[i].rho * e.gh[i];
+    }
+
+  es.m[k] = e.A * m;
+  es.I[k] = es.m[k] * e.i;          // moment of inertia update
+
+  /*
+   * TODO: clear this mess with planet.R, planet.R2 all around the code
+   */
+  ///////////// AAAAH!! Area and i has been calculated for UNIT SPHERE!
+  ///////////// So they are scaled manually down here
+  ///////////// And this should be removed (fixed, moved somewhere else...)
+  es.m[k] *= siku.planet.R2;
+  es.I[k] *= siku.planet.R2;
+
+  es.iRm[k] = 1. / ( siku.planet.R * es.m[k] );
+  es.iI[k] = 1. / es.I[k];
+
+  e.flag &= ~Element::F_MASS_DIRTY;
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+void mproperties_element( Globals& siku, const size_t k )
+{
+  auto& es = siku.es;
+
+  Element& e = es[k];
+
+  // mass properties are recomputed only after changes of gh, imat or A
+  // (sleeping elements too: they must be ready when woken up)
+  if( e.flag & Element::F_MASS_DIRTY )
+    _mass_props( siku, k );
+
+  // sleeping elements did not move and keep their properties
+  if( e.flag & Element::F_SLEEPING )
+    return;
+
+  // local 2d frame for contact kernels
+  e.update_frame();
+
+  if( e.flag & Element::F_ERRORED )
+    return;
+/////////////////
+  // input test: element`s NaN checks
+  bool nan_flag = false;
+
+  if( (nan_flag |= NaN( es.q[k] )) )
+      cout<<"\nERROR: NaN q at element "<<e.id<<" !\n"
+      <<es.q[k].w<<" "<<es.q[k].x<<" "<<es.q[k].y<<" "<<es.q[k].z<<" "
+      <<"\n";
+
+  nan_flag |= NaN( e.Glob );
+  if( NaN( e.Glob ) )
+      cout<<"\nERROR: NaN Glob at element "<<e.id<<" !\n"
+      <<e.Glob.x<<" "<<e.Glob.y<<" "<<e.Glob.z<<" "<<"\n";
+
+  nan_flag |= NaN( es.V[k] );
+  if( NaN( es.V[k] ) )
+      cout<<"\nERROR: NaN V at element "<<e.id<<" !\n"
+      <<es.V[k].x<<" "<<es.V[k].y<<" "<<es.V[k].z<<" "<<"\n";
+
+  nan_flag |= NaN( es.W[k] );
+  if( NaN( es.W[k] ) )
+      cout<<"\nERROR: NaN W at element "<<e.id<<" !\n"
+      <<es.W[k].x<<" "<<es.W[k].y<<" "<<es.W[k].z<<" "<<"\n";
+
+  if( nan_flag )
+    {
+      cout<<"NaN element "<<e.id<<endl;
+      e.flag |= Element::F_ERRORED;
+      fatal( 1, "NaN value in element");
+    }
+  assert( nan_flag ); // somehow - does not work!
+
+//      if( e.flag & Element::F_SPECIAL )
+//        {
+//          double lat, lon;
+//          Coordinates::sph_by_quat(es.q[k], &lat, &lon);
+//          cout<<"special "<<e.id<<"\t"<<Coordinates::rad_to_deg(lon)<<"\t"
+//              <<Coordinates::rad_to_deg(lat);
+//        }
+//////////////
+
+  // current global position is updated together with orientation in
+  // 'position' (see Element::update_orient)
+
+//// gone to 'clean_props'
+//      // clearing the force and the torque (and all other accumulating values
+//      es.F[k] = nullvec3d;
+//      es.N[k] = 0;
+
+  // marking element as it was already processed
+  e.flag |= Element::F_PROCESSED;
+
+  // checking land-fastency condition
+  if( e.flag & Element::F_FREE &&
+      ~e.flag & Element::F_FASTENED &&
+      e.OA &&
+      //OLD //e.OA > 0.0 )
+      (e.OA / e.OAM) > siku.pc.fastency )
+//          (e.OA / e.A) > siku.phys_consts["fastency"] )
+    {
+      e.flag &= ~( Element::F_FREE );//| Element::F_STEADY );
+      e.flag |= Element::F_STATIC | Element::F_FASTENED;
+    }
+  else
+    {
+      e.OA = 0.;
+      e.OAM = e.A;
+    }
+}
+
+// --------------------------------------------------------------------------
+
 void mproperties( Globals& siku )
 {
 //  size_t size = siku.es.size();
@@ -36,111 +166,15 @@ void mproperties( Globals& siku )
 //    cout<<"Cleared: "<<count<<" Elements after cleaning errors: "
 //        <<siku.es.size()<<endl;
 
-  for ( Element & e: siku.es )
-    {
-      if( e.flag & Element::F_ERRORED )
-        continue;
-/////////////////
-      // input test: element`s NaN checks
-      bool nan_flag = false;
-
-      if( (nan_flag |= NaN( e.q )) )
-          cout<<"\nERROR: NaN q at element "<<e.id<<" !\n"
-          <<e.q.w<<" "<<e.q.x<<" "<<e.q.y<<" "<<e.q.z<<" "<<"\n";
-
-      nan_flag |= NaN( e.Glob );
-      if( NaN( e.Glob ) )
-          cout<<"\nERROR: NaN Glob at element "<<e.id<<" !\n"
-          <<e.Glob.x<<" "<<e.Glob.y<<" "<<e.Glob.z<<" "<<"\n";
-
-      nan_flag |= NaN( e.V );
-      if( NaN( e.V ) )
-          cout<<"\nERROR: NaN V at element "<<e.id<<" !\n"
-          <<e.V.x<<" "<<e.V.y<<" "<<e.V.z<<" "<<"\n";
-
-      nan_flag |= NaN( e.W );
-      if( NaN( e.W ) )
-          cout<<"\nERROR: NaN W at element "<<e.id<<" !\n"
-          <<e.W.x<<" "<<e.W.y<<" "<<e.W.z<<" "<<"\n";
-
-      if( nan_flag )
-        {
-          cout<<"NaN element "<<e.id<<endl;
-          e.flag |= Element::F_ERRORED;
-          fatal( 1, "NaN value in element");
-        }
-      assert( nan_flag ); // somehow - does not work!
-
-//      if( e.flag & Element::F_SPECIAL )
-//        {
-//          double lat, lon;
-//          Coordinates::sph_by_quat(e.q, &lat, &lon);
-//          cout<<"special "<<e.id<<"\t"<<Coordinates::rad_to_deg(lon)<<"\t"
-//              <<Coordinates::rad_to_deg(lat);
-//        }
-//////////////
-
-      Material *pmat = &siku.ms[ e.imat ]; // short link to material
-
-      // mass update
-      double m = 0.;
-      for ( size_t i = 0; i < MAT_LAY_AMO; ++i )
-        {
-          m += pmat->layers[i].thickness * pmat->layers[i].rho * e.gh[i];
-        }
-
-      e.m = e.A * m;
-      e.I = e.m * e.i;          // moment of inertia update
-
-      /*
-       * TODO: clear this mess with planet.R, planet.R2 all around the code
-       */
-      ///////////// AAAAH!! Area and i has been calculated for UNIT SPHERE!
-      ///////////// So they are scaled manually down here
-      ///////////// And this should be removed (fixed, moved somewhere else...)
-      e.m *= siku.planet.R2;
-      e.I *= siku.planet.R2;
-
-//cout<<e.m<<"\t"<<e.I<<"\t"<<e.A*siku.planet.R2<<endl;
-//cin.get();
-      // current global position update
-      e.Glob = Coordinates::loc_to_glob ( e.q, Coordinates::NORTH );
-
-//// gone to 'clean_props'
-//      // clearing the force and the torque (and all other accumulating values
-//      e.F = nullvec3d;
-//      e.N = 0;
-
-      // marking element as it was already processed
-      e.flag |= Element::F_PROCESSED;
-
-      // checking land-fastency condition
-      if( e.flag & Element::F_FREE &&
-          ~e.flag & Element::F_FASTENED &&
-          e.OA &&
-          //OLD //e.OA > 0.0 )
-          (e.OA / e.OAM) > siku.phys_consts["fastency"] )
-//          (e.OA / e.A) > siku.phys_consts["fastency"] )
-        {
-          e.flag &= ~( Element::F_FREE );//| Element::F_STEADY );
-          e.flag |= Element::F_STATIC | Element::F_FASTENED;
-        }
-      else
-        {
-          e.OA = 0.;
-          e.OAM = e.A;
-        }
-    }
+  for ( size_t k = 0; k < siku.es.size(); ++k )
+    mproperties_element( siku, k );
 }
 
 // --------------------------------------------------------------------------
 
 void clean_props( Globals& siku )
 {
-  for ( Element & e: siku.es )
-    {
-      // clearing the force and the torque (and all other accumulating values
-      e.F = nullvec3d;
-      e.N = 0;
-    }
+  // clearing the force and the torque (and all other accumulating values
+  std::fill( siku.es.F.begin(), siku.es.F.end(), nullvec3d );
+  std::fill( siku.es.N.begin(), siku.es.N.end(), 0. );
 }
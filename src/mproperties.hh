@@ -16,6 +16,10 @@
 
 void mproperties( Globals& siku );
 
+//! \brief properties update of a single element at position 'k' (frame
+//! cache, NaN checks, mass, moment of inertia, fastening)
+void mproperties_element( Globals& siku, const size_t k );
+
 void clean_props( Globals& siku );
 
 #endif      /* MPROPERTIES_HH */
@@ -7,39 +7,116 @@
  */
 
 #include "position.hh"
+#include "geometry/quat_batch.hh"
 
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 void
-position ( Globals& siku, const double dt )
+position_element ( Globals& siku, const size_t i, const double dt )
 {
   //static const double C = 1.0 / 16.0;  // for second order precision
   quat p;
 
-  for ( auto & e : siku.es )
-    {
-//      if( e.flag & Element::F_ERRORED )   continue;
+  auto& es = siku.es;
+
+  quat& q = es.q[i];
+  vec3d& W = es.W[i];
+
+//      if( es[i].flag & Element::F_ERRORED )   continue;
 
-      if ( e.flag & Element::F_STATIC ) continue;
+  if ( es[i].flag & ( Element::F_STATIC | Element::F_SLEEPING ) ) return;
 
-      //double S = glm::dot ( e.W, e.W ) * dt * dt * C;
-      //p = quat ( 1 - S, 0.5 * dt * e.W )  / ( 1 + S );
-      //no self rotation
-      p = quat ( 1 , 0.5 * dt * vec3d( e.W.x, e.W.y, 0 ) );
-      //e.q = glm::cross ( e.q, p );
+  //double S = glm::dot ( W, W ) * dt * dt * C;
+  //p = quat ( 1 - S, 0.5 * dt * W )  / ( 1 + S );
+  //no self rotation
+  p = quat ( 1 , 0.5 * dt * vec3d( W.x, W.y, 0 ) );
+  //q = glm::cross ( q, p );
 
 ////////////////
-      //translation
-      e.q = glm::cross ( e.q, p );
-      p = quat(1, 0.5*dt*vec3d(0,0,e.W.z));
-      //rotation
-      quat t = glm::cross ( e.q, p );
-      e.W = Coordinates::loc_to_loc( t, e.q, e.W );
-      e.q = t;
+  //translation
+  q = glm::cross ( q, p );
+  p = quat(1, 0.5*dt*vec3d(0,0,W.z));
+  //rotation
+  quat t = glm::cross ( q, p );
+  W = Coordinates::loc_to_loc( t, q, W );
+  q = t;
 ////////////////////
 
-      e.q = glm::normalize( e.q );
-      VERIFY( e.q, "positioning");
+  q = glm::normalize( q );
+  VERIFY( q, "positioning");
+
+  // rotation matrix, global position and lat-lon for all other kernels
+  es[i].update_orient( q );
+}
+
+// --------------------------------------------------------------------------
+
+void
+position ( Globals& siku, const double dt )
+{
+  for ( size_t i = 0; i < siku.es.size(); ++i )
+    position_element ( siku, i, dt );
+}
+
+// --------------------------------------------------------------------------
+
+void
+position_block ( Globals& siku, const size_t beg, const size_t end,
+                 const double dt )
+{
+  // moving elements of current chunk gathered contiguously
+  size_t idx[ POSITION_BLOCK ];
+  quat q[ POSITION_BLOCK ], p[ POSITION_BLOCK ], t[ POSITION_BLOCK ];
+  vec3d W[ POSITION_BLOCK ];
+  mat3d R[ POSITION_BLOCK ];
+  double lat[ POSITION_BLOCK ], lon[ POSITION_BLOCK ];
+
+  auto& es = siku.es;
+
+  for ( size_t b = beg; b < end; b += POSITION_BLOCK )
+    {
+      const size_t e = std::min( end, b + POSITION_BLOCK );
+
+      size_t n = 0;
+      for ( size_t i = b; i < e; ++i )
+        if ( !( es[i].flag & ( Element::F_STATIC | Element::F_SLEEPING ) ) )
+          {
+            idx[n] = i;
+            q[n] = es.q[i];
+            W[n] = es.W[i];
+            ++n;
+          }
+
+      // translation (no self rotation)
+      for ( size_t k = 0; k < n; ++k )
+        p[k] = quat ( 1 , 0.5 * dt * vec3d( W[k].x, W[k].y, 0 ) );
+      quats_mul( q, p, q, n );
+
+      // rotation
+      for ( size_t k = 0; k < n; ++k )
+        p[k] = quat ( 1, 0.5 * dt * vec3d( 0, 0, W[k].z ) );
+      quats_mul( q, p, t, n );
+
+      // W from old local frame 'q' to new one 't' (Coordinates::loc_to_loc)
+      quats_cmul( t, q, p, n );
+      quats_rotate( p, W, W, n );
+
+      quats_normalize( t, n );
+
+      // rotation matrix, global position and lat-lon for all other kernels
+      quats_to_m3( t, R, n );
+      quats_lat_lon( t, lat, lon, n );
+
+      for ( size_t k = 0; k < n; ++k )
+        {
+          const size_t i = idx[k];
+          VERIFY( t[k], "positioning");
+
+          es.q[i] = t[k];
+          es.W[i] = W[k];
+          es[i].set_orient( R[k], lat[k], lon[k] );
+        }
     }
 }
@@ -14,4 +14,20 @@
 void
 position ( Globals& siku, const double dt );
 
+//! \brief position update of a single element at position 'i'. Elements are
+//! independent, so it may be called concurrently for different elements
+void
+position_element ( Globals& siku, const size_t i, const double dt );
+
+//! \brief amount of elements processed by batched kernels at once in
+//! 'position_block' (their temporal data stays in L1 cache)
+static const size_t POSITION_BLOCK = 64;
+
+//! \brief position update of elements at positions [beg, end) by batched
+//! quaternion kernels (see 'quat_batch.hh'). Same as 'position_element' for
+//! each of them up to rounding
+void
+position_block ( Globals& siku, const size_t beg, const size_t end,
+                 const double dt );
+
 #endif      /* POSITION_HH */
@@ -0,0 +1,83 @@
+/*!
+
+ \file reorder.cc
+
+ \brief Spatial reordering of elements along Morton curve
+
+ */
+
+#include "reorder.hh"
+
+#include <algorithm>
+#include <cstdint>
+
+// bits per coordinate in Morton code (3*21 = 63 bits)
+static const unsigned MORTON_BITS = 21;
+
+// spreads lower 21 bits of x so there are two zero bits between each
+inline uint64_t _spread3( uint64_t x )
+{
+  x &= 0x1fffff;
+  x = ( x | x << 32 ) & 0x1f00000000ffffULL;
+  x = ( x | x << 16 ) & 0x1f0000ff0000ffULL;
+  x = ( x | x << 8 )  & 0x100f00f00f00f00fULL;
+  x = ( x | x << 4 )  & 0x10c30c30c30c30c3ULL;
+  x = ( x | x << 2 )  & 0x1249249249249249ULL;
+  return x;
+}
+
+// Morton code of a point from [-1, 1]^3 cube (all points on unit sphere)
+inline uint64_t _morton( const vec3d& p )
+{
+  static const double S = 0.5 * double( ( 1u << MORTON_BITS ) - 1 );
+
+  auto q = [] ( double c ) -> uint64_t
+    {
+      c = std::min( 1., std::max( -1., c ) );
+      return uint64_t( ( c + 1. ) * S );
+    };
+
+  return _spread3( q( p.x ) ) | _spread3( q( p.y ) ) << 1
+       | _spread3( q( p.z ) ) << 2;
+}
+
+//---------------------------------------------------------------------
+
+void
+reorder ( Globals& siku )
+{
+  static std::vector<std::pair<uint64_t, size_t>> keys;  // code, position
+  static std::vector<size_t> new_slot;  // new position by old one
+  static std::vector<size_t> from;      // old position by new one
+
+  const size_t n = siku.es.size();
+
+  keys.resize( n );
+  for( size_t i = 0; i < n; ++i )
+    keys[i] = std::make_pair( _morton( siku.es[i].Glob ), i );
+
+  // equal codes are ordered by positions: the result is deterministic
+  std::sort( keys.begin(), keys.end() );
+
+  bool moved = false;
+  new_slot.resize( n );
+  for( size_t k = 0; k < n; ++k )
+    {
+      new_slot[ keys[k].second ] = k;
+      moved |= keys[k].second != k;
+    }
+
+  if( !moved ) return;
+
+  from.resize( n );
+  for( size_t k = 0; k < n; ++k )
+    from[k] = keys[k].second;
+  siku.es.permute( from );
+
+  for( size_t k = 0; k < n; ++k )
+    siku.slot[ siku.es[k].id ] = k;
+
+  siku.ConDet.renumber( new_slot );
+}
+
+//---------------------------------------------------------------------
@@ -0,0 +1,20 @@
+/*!
+
+ \file reorder.hh
+
+ \brief Spatial reordering of elements for memory locality
+
+ */
+
+#ifndef REORDER_HH
+#define REORDER_HH
+
+#include "globals.hh"
+
+//! \brief Sorts elements in 'siku.es' along Morton (Z-order) curve over
+//! their 'Glob' positions, so neighbouring floes are close in memory.
+//! Updates 'siku.slot' and renumbers contacts. IDs remain unchanged.
+void
+reorder ( Globals& siku );
+
+#endif      /* REORDER_HH */
@@ -52,11 +52,14 @@ extern "C"
 #include "contact_force.hh"
 #include "dynamics.hh"
 #include "position.hh"
+#include "integrate.hh"
 #include "coordinates.hh"
 
 #include "highio.hh"
 #include "monitoring.hh"
 #include "mproperties.hh"
+#include "reorder.hh"
+#include "sleeping.hh"
 
 #include "contact_detect.hh"
 
@@ -147,9 +150,23 @@ main ( int argc, char* argv[] )
       // --- pretimestep
       (void) sikupy.fcall_pretimestep ( siku );
 
+      // --- Spatial reordering of elements storage
+      if( siku.reorder_period
+          && siku.time.get_n() % siku.reorder_period == 0 )
+        reorder( siku );
+
       // --- Searching for interaction pairs
       siku.ConDet.detect( siku );
 
+      if( siku.ConDet.cstats.tested() && siku.ConDet.det_cascade )
+        cout<<"Mid phase rejected (cap/box/poly): "
+            <<siku.ConDet.cstats.cap<<" / "<<siku.ConDet.cstats.obb<<" / "
+            <<siku.ConDet.cstats.poly<<", passed: "
+            <<siku.ConDet.cstats.passed<<endl;
+
+      // --- Waking sleeping islands up by new contacts and forcing
+      sleeping_wake( siku );
+
       // --- Broad Phase Contact Detection if necessary
 
       // ------------------------- physics ------------------------------
@@ -160,14 +177,25 @@ main ( int argc, char* argv[] )
       // --- Contact Forces assignment (Elements` interaction)
       contact_forces( siku );
 
-      // --- Dynamics solution
-      dynamics ( siku, dt );
+      if( siku.fused_integr )
+        {
+          // --- Dynamics, position and state update in one pass
+          integrate ( siku, dt );
+        }
+      else
+        {
+          // --- Dynamics solution
+          dynamics ( siku, dt );
+
+          // --- Position update
+          position ( siku, dt );
 
-      // --- Position update
-      position ( siku, dt );
+          // --- State update
+          mproperties ( siku );
+        }
 
-      // --- State update
-      mproperties ( siku );
+      // --- Putting calm islands to sleep
+      sleeping_update( siku );
 
       // ------------------------- postactions ------------------------------
 
@@ -207,6 +235,27 @@ main ( int argc, char* argv[] )
   // finalizing
   sikupy.fcall_conclusions( siku );
 
+  if( siku.sleep_steps )
+    cout<<"\nSleeping elements at the end: "<<sleeping_count( siku )<<endl;
+
+  cout<<"\nNarrow phase buffers reallocations: "<<contact_scratch_grows()
+      <<endl;
+
+#ifdef SIKU_CONTACT_STATS
+  unsigned long sat_h, sat_m, sat_o;
+  contact_sat_stats( sat_h, sat_m, sat_o );
+  cout<<"Separating axis test: "<<sat_h<<" witness hits, "<<sat_m
+      <<" misses, "<<sat_o<<" overlaps"<<endl;
+#endif
+
+#ifdef SIKU_PRECISION_CHECK
+  unsigned long prec_c, prec_m;
+  double prec_e;
+  contact_precision_stats( prec_c, prec_m, prec_e );
+  cout<<"Narrow phase precision check: "<<prec_c<<" intersections, "<<prec_m
+      <<" mismatched, max relative area error "<<prec_e<<endl;
+#endif
+
   cout<<"\nDONE!\n";
   return 0;
 }
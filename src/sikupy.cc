@@ -212,6 +212,13 @@ Sikupy::read_settings( Globals& siku )
   success &= read_double( pTemp, siku.ConDet.det_value );
   Py_DECREF( pTemp );
 
+  // read depth of mid phase tests cascade
+  pTemp = PyObject_GetAttrString ( pDef, "contact_cascade" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.ConDet.det_cascade );
+  Py_DECREF( pTemp );
+
   // read contact force model flag
   pTemp = PyObject_GetAttrString ( pDef, "force_model" );
   assert( pTemp );
@@ -220,6 +227,13 @@ Sikupy::read_settings( Globals& siku )
   siku.cont_force_model = CONTACT_FORCE_MODEL( i );
   Py_DECREF( pTemp );
 
+  // read deterministic contact forces summation flag
+  pTemp = PyObject_GetAttrString ( pDef, "deterministic_sum" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.cont_det_sum );
+  Py_DECREF( pTemp );
+
   // read wind source
   pTemp = PyObject_GetAttrString ( pDef, "wind_source_type" );
   assert( pTemp );
@@ -228,6 +242,58 @@ Sikupy::read_settings( Globals& siku )
   siku.wind.FIELD_SOURCE_TYPE = Vecfield::Source_Type( i );
   Py_DECREF( pTemp );
 
+  // read period of elements reordering
+  pTemp = PyObject_GetAttrString ( pDef, "reorder_period" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.reorder_period );
+  Py_DECREF( pTemp );
+
+  // read collision proxies parameters
+  pTemp = PyObject_GetAttrString ( pDef, "proxy_vertices" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.proxy_verts );
+  Py_DECREF( pTemp );
+
+  pTemp = PyObject_GetAttrString ( pDef, "proxy_error" );
+  assert( pTemp );
+
+  success &= read_double( pTemp, siku.proxy_err );
+  Py_DECREF( pTemp );
+
+  // read integration pass type
+  pTemp = PyObject_GetAttrString ( pDef, "fused_integration" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.fused_integr );
+  Py_DECREF( pTemp );
+
+  // read sleeping parameters
+  pTemp = PyObject_GetAttrString ( pDef, "sleep_steps" );
+  assert( pTemp );
+
+  success &= read_ulong( pTemp, siku.sleep_steps );
+  Py_DECREF( pTemp );
+
+  pTemp = PyObject_GetAttrString ( pDef, "sleep_velocity" );
+  assert( pTemp );
+
+  success &= read_double( pTemp, siku.sleep_velo );
+  Py_DECREF( pTemp );
+
+  pTemp = PyObject_GetAttrString ( pDef, "sleep_spin" );
+  assert( pTemp );
+
+  success &= read_double( pTemp, siku.sleep_spin );
+  Py_DECREF( pTemp );
+
+  pTemp = PyObject_GetAttrString ( pDef, "sleep_acceleration" );
+  assert( pTemp );
+
+  success &= read_double( pTemp, siku.sleep_accel );
+  Py_DECREF( pTemp );
+
   // read initial freezing mask
   pTemp = PyObject_GetAttrString ( pDef, "initial_freeze" );
   assert( pTemp );
@@ -638,6 +704,9 @@ Sikupy::read_elements ( Globals& siku )
 
   // array sets length
   siku.es.resize ( nes );
+  siku.es.verts.clear();
+
+  vector < vec3d > P;           // vertices of current element
 
   // reading all elements in this loop
   for ( Py_ssize_t i = 0; i < nes; ++i )
@@ -674,7 +743,7 @@ Sikupy::read_elements ( Globals& siku )
       pobj = PyObject_GetAttrString ( pitem, "q" ); // new
       assert( pobj );
 
-      success = read_quat ( pobj, siku.es[i].q );
+      success = read_quat ( pobj, siku.es.q[i] );
       assert( success );
 
       Py_DECREF( pobj );
@@ -722,9 +791,13 @@ Sikupy::read_elements ( Globals& siku )
       pobj = PyObject_GetAttrString ( pitem, "verts_xyz_loc" );
       assert( pobj );
 
-      success = read_vec3d_vector ( pobj, siku.es[i].P );
+      success = read_vec3d_vector ( pobj, P );
       assert( success );
 
+      // to the vertices pool, element position is its future ID
+      for ( auto& p : P )
+        siku.es.verts.push_back( Element::vertex( p, i ) );
+
       Py_DECREF( pobj );
 
       // reading material index
@@ -772,17 +845,19 @@ Sikupy::read_elements ( Globals& siku )
 
       pobj = PyObject_GetAttrString ( pitem, "velo" );
 
-      read_vec3d( pobj, siku.es[i].V );
+      read_vec3d( pobj, siku.es.V[i] );
 
       Py_DECREF( pobj );
 
       // Additional initialization without reading
 
       // could be inited in Globals.post_init() in main()
-      siku.es[i].W = nullvec3d;
+      siku.es.W[i] = nullvec3d;
 
     }
 
+  siku.es.bind_verts();
+
   Py_DECREF( pSiku_elements );
 
   return success;
@@ -1086,6 +1161,8 @@ Sikupy::fcall_pretimestep ( Globals& siku )
 
   // Calls for inner methods. Mask is being checked inside each of them
   status |= fcall_update_wind ( siku );
+  status |= fcall_update_consts ( siku );
+  status |= fcall_update_materials ( siku );
 
   Py_DECREF( pReturnValue );
 
@@ -1168,12 +1245,61 @@ Sikupy::fcall_update_wind ( Globals& siku )
       break;  //-----------------------------
     }
 
+  ++siku.forcing_changes;  // sleeping elements must check new forcing
+
   siku.callback_status &= ~STATUS_WINDS;
   return FCALL_OK;
 }
 
 //---------------------------------------------------------------------
 
+int
+Sikupy::fcall_update_consts ( Globals& siku )
+{
+  if ( !( siku.callback_status & STATUS_PHYS_CONSTS ) )
+    return FCALL_OK;
+
+  PyObject* pDef = PyObject_GetAttrString ( pSiku, "settings" ); // new
+  assert( pDef );
+
+  PyObject* pTemp = PyObject_GetAttrString ( pDef, "phys_consts" ); // new
+  assert( pTemp );
+
+  siku.phys_consts.clear();
+  bool success = read_str_doub_map( pTemp, siku.phys_consts );
+
+  Py_DECREF( pTemp );
+  Py_DECREF( pDef );
+
+  if( !success )
+    fatal( 1, "Wrong phys_consts update" );
+
+  siku.resolve_consts();
+  ++siku.forcing_changes;  // drag factors may be changed
+
+  siku.callback_status &= ~STATUS_PHYS_CONSTS;
+  return FCALL_OK;
+}
+
+//---------------------------------------------------------------------
+
+int
+Sikupy::fcall_update_materials ( Globals& siku )
+{
+  if ( !( siku.callback_status & STATUS_MATERIALS ) )
+    return FCALL_OK;
+
+  if( !read_materials( siku.ms ) )
+    fatal( 1, "Wrong materials update" );
+
+  siku.mass_changed();
+
+  siku.callback_status &= ~STATUS_MATERIALS;
+  return FCALL_OK;
+}
+
+//---------------------------------------------------------------------
+
 int
 Sikupy::fcall_inits ( Globals& siku )
 {
@@ -1289,7 +1415,8 @@ Sikupy::fcall_monitor( const Globals& siku, const size_t i, const char* fname )
   int status = FCALL_OK;
 
   // direct reference to the element to store
-  const Element* pe = &siku.es[i];
+  const auto r = siku.es.ref( i );
+  const Element* pe = &r.e;
   //Element ee = *pe;
 
 
@@ -1298,7 +1425,7 @@ Sikupy::fcall_monitor( const Globals& siku, const size_t i, const char* fname )
 
   for ( Py_ssize_t k = 0; k < 4; ++k )
     {
-      PyObject* pNum = PyFloat_FromDouble ( pe->q[ (k+3)%4 ] );
+      PyObject* pNum = PyFloat_FromDouble ( r.q[ (k+3)%4 ] );
           // ^-number to fill into the tuple // new
 
       PyTuple_SET_ITEM( pQTuple, k, pNum );  // steals pNum
@@ -1329,7 +1456,7 @@ Sikupy::fcall_monitor( const Globals& siku, const size_t i, const char* fname )
 
   for ( Py_ssize_t k = 0; k < 3; ++k )
     {
-      PyObject* pNum = PyFloat_FromDouble ( pe->W[k] );
+      PyObject* pNum = PyFloat_FromDouble ( r.W[k] );
           // ^-number to fill into the tuple // new
       PyTuple_SET_ITEM( pWTuple, k, pNum );  // steals pNum
     }
@@ -1340,7 +1467,7 @@ Sikupy::fcall_monitor( const Globals& siku, const size_t i, const char* fname )
 
   for ( Py_ssize_t k = 0; k < 3; ++k )
     {
-      PyObject* pNum = PyFloat_FromDouble ( pe->F[k] );
+      PyObject* pNum = PyFloat_FromDouble ( r.F[k] );
           // ^-number to fill into the tuple // new
       PyTuple_SET_ITEM( pFTuple, k, pNum );  // steals pNum
     }
@@ -1355,14 +1482,14 @@ Sikupy::fcall_monitor( const Globals& siku, const size_t i, const char* fname )
                             pQTuple,        // quat
                             pPiList,        // vertices
                             pe->flag,       // state flag
-                            i,              // index in array
+                            (unsigned int) pe->id, // index in original array
                             pe->id,         // id of element
                             pWTuple,        // angle velocity
                             pFTuple,        // current force
-                            pe->N,          // torque (2d)
+                            r.N,            // torque (2d)
 
-                            pe->m,          // mass
-                            pe->I,          // moment of inertia
+                            r.m,            // mass
+                            r.I,            // moment of inertia
                             pe->i,          // geometric moment of inertia
                             pe->A,          // area (on unit sphere)
                             pe->anchority,  // water interaction factor
@@ -107,6 +107,19 @@ public:
   int
   fcall_update_wind ( Globals& siku );
 
+  //! \brief Re-read and resolve physical constants after python has
+  //! changed them (STATUS_PHYS_CONSTS returned from pretimestep)
+  //! \param[in] siku main global variables container
+  int
+  fcall_update_consts ( Globals& siku );
+
+  //! \brief Re-read materials after python has changed them
+  //! (STATUS_MATERIALS returned from pretimestep) and mark masses of all
+  //! elements for recomputation
+  //! \param[in] siku main global variables container
+  int
+  fcall_update_materials ( Globals& siku );
+
 //  //! \brief Check and perform winds update
 //  //! \param[in] siku main global variables container
 //  int
@@ -0,0 +1,208 @@
+/*!
+
+ \file sleeping.cc
+
+ \brief Islands of calm elements are put to sleep and skipped by all
+ phases (forces, dynamics, position, properties) until woken up
+
+ */
+
+#include "sleeping.hh"
+#include "forces_mass.hh"
+
+#include <algorithm>
+#include <climits>
+
+// elements that do not sleep and do not connect islands: static ones do not
+// move, steady ones keep their prescribed velocity
+static const unsigned int NO_SLEEP =
+    Element::F_ERRORED | Element::F_STATIC | Element::F_STEADY;
+
+// ----------------------------- local utils --------------------------------
+
+// awake element that may fall asleep
+inline bool _awake( const Element& e )
+{
+  return !( e.flag & ( NO_SLEEP | Element::F_SLEEPING ) );
+}
+
+// element that may push a sleeping neighbour: awake free element or steady
+// one with nonzero prescribed velocity
+inline bool _waker( const Globals& siku, size_t i )
+{
+  const unsigned int f = siku.es[i].flag;
+  if( f & ( Element::F_ERRORED | Element::F_STATIC | Element::F_SLEEPING ) )
+    return false;
+  return !( f & Element::F_STEADY )
+      || siku.es.V[i] != vec3d() || siku.es.W[i] != vec3d();
+}
+
+// union-find root with path halving
+inline size_t _root( std::vector<size_t>& up, size_t i )
+{
+  while( up[i] != i )
+    {
+      up[i] = up[ up[i] ];
+      i = up[i];
+    }
+  return i;
+}
+
+// wakes all elements of islands listed in 'ids' (list is cleared)
+static void _wake( Globals& siku, std::vector<size_t>& ids )
+{
+  if( ids.empty() ) return;
+
+  std::sort( ids.begin(), ids.end() );
+  ids.erase( std::unique( ids.begin(), ids.end() ), ids.end() );
+
+  for( auto& e : siku.es )
+    if( ( e.flag & Element::F_SLEEPING )
+        && std::binary_search( ids.begin(), ids.end(), e.island ) )
+      {
+        e.flag &= ~Element::F_SLEEPING;
+        e.calm = 0;
+        --siku.sleep_count;
+      }
+
+  ids.clear();
+}
+
+//---------------------------------------------------------------------
+
+void
+sleeping_wake ( Globals& siku )
+{
+  static std::vector<size_t> ids;  // islands to wake up
+
+  if( !siku.sleep_steps || !siku.sleep_count ) return;
+
+  // contacts with awake or steady moving elements. Free elements in contact
+  // were inside the island when it fell asleep, so these contacts are new.
+  for( auto& c : siku.ConDet.cont )
+    {
+      const Element& e1 = siku.es[c.i1], & e2 = siku.es[c.i2];
+
+      if( ( e1.flag & Element::F_SLEEPING ) && _waker( siku, c.i2 ) )
+        ids.push_back( e1.island );
+      else if( ( e2.flag & Element::F_SLEEPING ) && _waker( siku, c.i1 ) )
+        ids.push_back( e2.island );
+    }
+
+  // manually forced elements
+  for( auto id : siku.man_inds )
+    {
+      const Element& e = siku.es[ siku.slot[ id ] ];
+      if( e.flag & Element::F_SLEEPING )
+        ids.push_back( e.island );
+    }
+
+  // mass forces change after wind update or constants refresh
+  if( siku.sleep_forcing_seen != siku.forcing_changes )
+    {
+      siku.sleep_forcing_seen = siku.forcing_changes;
+
+      for( size_t i = 0; i < siku.es.size(); ++i )
+        {
+          const Element& e = siku.es[i];
+          if( ( e.flag & Element::F_SLEEPING )
+              && abs( mass_force( siku, i ) - e.Fm )
+                 > siku.sleep_accel * siku.es.m[i] )
+            ids.push_back( e.island );
+        }
+    }
+
+  _wake( siku, ids );
+}
+
+//---------------------------------------------------------------------
+
+void
+sleeping_update ( Globals& siku )
+{
+  static std::vector<size_t> up;        // union-find parents
+  static std::vector<unsigned> low;     // minimal calm of island (by root)
+  static std::vector<size_t> isl;       // island id (by root)
+
+  // new islands use current forcing
+  siku.sleep_forcing_seen = siku.forcing_changes;
+
+  if( !siku.sleep_steps ) return;
+
+  const size_t n = siku.es.size();
+  bool ready = false;  // some element is calm long enough
+
+  // calm counters: speed, spin and acceleration are below thresholds
+  for( size_t i = 0; i < n; ++i )
+    {
+      Element& e = siku.es[i];
+      if( !_awake( e ) ) continue;
+
+      if( abs( siku.es.V[i] ) < siku.sleep_velo
+          && std::abs( siku.es.W[i].z ) < siku.sleep_spin
+          && abs( siku.es.F[i] ) < siku.sleep_accel * siku.es.m[i] )
+        {
+          if( e.calm < siku.sleep_steps ) ++e.calm;
+        }
+      else
+        e.calm = 0;
+    }
+
+  // manually forced elements are never calm
+  for( auto id : siku.man_inds )
+    siku.es[ siku.slot[ id ] ].calm = 0;
+
+  for( auto& e : siku.es )
+    if( _awake( e ) && e.calm >= siku.sleep_steps )
+      {
+        ready = true;
+        break;
+      }
+
+  if( !ready ) return;
+
+  // islands: awake elements connected by contacts
+  up.resize( n );
+  for( size_t i = 0; i < n; ++i )
+    up[i] = i;
+
+  for( auto& c : siku.ConDet.cont )
+    if( _awake( siku.es[c.i1] ) && _awake( siku.es[c.i2] ) )
+      up[ _root( up, c.i1 ) ] = _root( up, c.i2 );
+
+  low.assign( n, UINT_MAX );
+  for( size_t i = 0; i < n; ++i )
+    if( _awake( siku.es[i] ) )
+      {
+        size_t r = _root( up, i );
+        low[r] = std::min( low[r], siku.es[i].calm );
+      }
+
+  // islands with all elements calm fall asleep
+  isl.assign( n, 0 );
+  for( size_t i = 0; i < n; ++i )
+    {
+      Element& e = siku.es[i];
+      if( !_awake( e ) ) continue;
+
+      size_t r = _root( up, i );
+      if( low[r] < siku.sleep_steps ) continue;
+
+      if( !isl[r] ) isl[r] = ++siku.sleep_next_island;
+
+      e.flag |= Element::F_SLEEPING;
+      e.island = isl[r];
+      siku.es.V[i] = {};
+      siku.es.W[i] = {};
+      e.Fm = mass_force( siku, i );
+      ++siku.sleep_count;
+    }
+}
+
+//---------------------------------------------------------------------
+
+size_t
+sleeping_count ( const Globals& siku )
+{
+  return siku.sleep_count;
+}
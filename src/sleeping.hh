@@ -0,0 +1,32 @@
+/*!
+
+ \file sleeping.hh
+
+ \brief Deactivation (sleeping) of calm islands of elements
+
+ */
+
+#ifndef SLEEPING_HH
+#define SLEEPING_HH
+
+#include "globals.hh"
+
+//! \brief Wakes sleeping islands up if any of their elements got a contact
+//! with awake moving element, got manual force or (after external forcing
+//! update) its mass force changed above 'siku.sleep_accel'. Must be called
+//! after contacts detection.
+void
+sleeping_wake ( Globals& siku );
+
+//! \brief Updates calm counters of awake elements and puts to sleep
+//! islands (elements connected by contacts) whose elements all stayed calm
+//! for 'siku.sleep_steps' steps. Must be called after 'mproperties' (net
+//! forces are not cleaned yet).
+void
+sleeping_update ( Globals& siku );
+
+//! \brief amount of sleeping elements
+size_t
+sleeping_count ( const Globals& siku );
+
+#endif      /* SLEEPING_HH */